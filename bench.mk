@@ -0,0 +1,40 @@
+BENCH := wmbench
+LDLIBS := -lX11 -pthread
+OBJDIR := bin
+INCDIR := include
+SRCDIR := src
+BENCHDIR := bench
+SRC := $(filter-out $(SRCDIR)/wm.cpp $(SRCDIR)/wmevent.cpp $(SRCDIR)/wmreplay.cpp, $(wildcard $(SRCDIR)/*.cpp))
+SRC += $(wildcard $(BENCHDIR)/*.cpp)
+CC := g++
+CXXFLAGS := -pedantic -Wall -Wextra -Wfloat-equal -Wwrite-strings -Wno-unused-parameter -Wundef -Wcast-qual -Wshadow -Wredundant-decls -std=c++17 -I$(INCDIR) -I$(BENCHDIR)
+BENCHFLAGS := -O2
+
+#GRID=CxR lays the workspaces out as a C x R grid, see include/workspaces.hpp
+ifdef GRID
+CXXFLAGS += -DWM_GRID_COLUMNS=$(word 1,$(subst x, ,$(GRID))) -DWM_GRID_ROWS=$(word 2,$(subst x, ,$(GRID)))
+endif
+#Holds the GRID the objects in OBJDIR were built for, see the rule below
+GRIDSTAMP := $(OBJDIR)/grid
+
+BENCH := $(OBJDIR)/$(BENCH)
+
+bench: $(BENCH)
+	./$(BENCH)
+	./$(BENCHDIR)/headless.sh
+	WMFLAGS="-H iconify" ./$(BENCHDIR)/headless.sh hidden_cpu
+	WMFLAGS="-H container" ./$(BENCHDIR)/headless.sh workspace_go hidden_cpu
+
+$(BENCH): $(SRC) $(wildcard $(INCDIR)/*.hpp $(BENCHDIR)/*.hpp) $(GRIDSTAMP)
+	-mkdir -p $(OBJDIR)
+	$(CC) -o $@ $(SRC) $(LDLIBS) $(CXXFLAGS) $(BENCHFLAGS)
+
+#Checked on every build, but only rewritten when GRID changed, so switching
+#grids rebuilds the objects and nothing else does
+$(GRIDSTAMP): FORCE
+	@mkdir -p $(OBJDIR)
+	@[ -f $@ ] && [ "$$(cat $@)" = "$(GRID)" ] || echo "$(GRID)" > $@
+
+FORCE:
+
+.PHONY: bench FORCE
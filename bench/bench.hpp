@@ -0,0 +1,41 @@
+#pragma once
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include <functional>
+#include <cstddef>
+#include <vector>
+
+//Minimal in-process benchmark harness, results are printed as CSV rows:
+//benchmark,n,ns_per_op,p50_ns,p90_ns,p99_ns,max_ns
+//or as a JSON array of the same fields with -j. Percentiles are only
+//filled in by benchmarks that time every operation on its own.
+namespace Bench {
+
+using Run = void(*)();
+
+//Per operation latencies, in nanoseconds
+using Samples = std::vector<double>;
+
+//Registers a benchmark at static initialization time
+struct Register {
+	Register(const char *name, Run run);
+};
+
+//Average wall time of one call to op, in nanoseconds
+double measure(size_t iterations, const std::function<void(size_t)> &op);
+
+//Nanoseconds since an arbitrary, fixed point
+double now();
+
+void report(const char *benchmark, size_t n, double nsPerOp);
+
+//Mean and percentiles of samples
+void report(const char *benchmark, size_t n, Samples &samples);
+
+//Sizes every scaling benchmark sweeps over
+constexpr size_t sizes[] = {10, 100, 1000, 10000};
+
+}
+
+#endif
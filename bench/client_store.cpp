@@ -0,0 +1,94 @@
+#include "client_store.hpp"
+#include "bench.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+//Event handlers resolve e.window to a Client on every ConfigureRequest,
+//EnterNotify, MotionNotify, ButtonPress and UnmapNotify. These compare the
+//old linear vector scan against the slot map store as the client count grows.
+
+namespace {
+
+constexpr size_t lookups = 1 << 20;
+constexpr size_t churns = 1 << 16;
+
+//X resource ids are handed out per connection, spread them the same way
+Window windowId(size_t i) {
+	return static_cast<Window>(0x200001 + (i % 64) * 0x200000 + i / 64);
+}
+
+std::vector<Window> shuffled(size_t n) {
+	std::vector<Window> windows(n);
+	for(size_t i = 0; i < n; i++) windows[i] = windowId(i);
+	std::shuffle(windows.begin(), windows.end(), std::mt19937(n) );
+	return windows;
+}
+
+Client makeClient(Window w) {
+	Client client;
+	client.window = w;
+	client.workspace = 0;
+	return client;
+}
+
+void vectorLookup() {
+	for(size_t n : Bench::sizes) {
+		std::vector<Client> clients;
+		for(size_t i = 0; i < n; i++) clients.push_back(makeClient(windowId(i) ) );
+		const auto order = shuffled(n);
+
+		volatile int sink = 0;
+		const size_t iterations = std::max<size_t>(lookups / n, 1024);
+		double ns = Bench::measure(iterations, [&](size_t i) {
+			const Window w = order[i % n];
+			auto it = std::find_if(clients.begin(), clients.end(), [&](const Client &c) {
+				return c.window == w;
+			});
+			sink += it->workspace;
+		});
+
+		Bench::report("vector_lookup", n, ns);
+	}
+}
+
+void storeLookup() {
+	for(size_t n : Bench::sizes) {
+		ClientStore clients(1);
+		for(size_t i = 0; i < n; i++) clients.insert(makeClient(windowId(i) ) );
+		const auto order = shuffled(n);
+
+		volatile int sink = 0;
+		double ns = Bench::measure(lookups, [&](size_t i) {
+			sink += clients.find(order[i % n])->workspace;
+		});
+
+		Bench::report("store_lookup", n, ns);
+	}
+}
+
+//Map/unmap churn: one window leaves and another takes its place
+void storeChurn() {
+	for(size_t n : Bench::sizes) {
+		ClientStore clients(1);
+		for(size_t i = 0; i < n; i++) clients.insert(makeClient(windowId(i) ) );
+		auto order = shuffled(n);
+
+		Window fresh = windowId(n);
+		double ns = Bench::measure(churns, [&](size_t i) {
+			Window &victim = order[i % n];
+			clients.erase(victim);
+			clients.insert(makeClient(fresh) );
+			victim = fresh++;
+		});
+
+		Bench::report("store_churn", n, ns);
+	}
+}
+
+const Bench::Register vectorLookupCase("vector_lookup", &vectorLookup);
+const Bench::Register storeLookupCase("store_lookup", &storeLookup);
+const Bench::Register storeChurnCase("store_churn", &storeChurn);
+
+}
@@ -0,0 +1,126 @@
+#include "core.hpp"
+#include "mock_backend.hpp"
+#include "bench.hpp"
+
+#include <vector>
+
+//Window management logic on its own, against MockBackend: no server, no
+//round-trips, only what Core spends deciding. Each case also reports the
+//requests one operation hands the backend, the part a server would see.
+
+namespace {
+
+constexpr size_t operations = 1 << 14;
+constexpr size_t churns = 1 << 12;
+const Vector2 screen = {1920, 1080};
+
+Client makeClient(size_t i) {
+	Client client;
+	client.window = static_cast<Window>(0x200001 + i);
+	client.workspace = 0;
+	client.position = {static_cast<int>(i % 64) * 8, static_cast<int>(i % 48) * 6};
+	client.size = {320, 240};
+	client.sentPosition = client.position;
+	client.sentSize = client.size;
+	client.mapped = true;
+	return client;
+}
+
+//n clients spread round robin over the first workspaces, all committed
+void populate(Core &core, MockBackend &backend, size_t n, int workspaces) {
+	core.createContainers();
+	for(size_t i = 0; i < n; i++) {
+		Rules::Actions actions;
+		actions.workspace = static_cast<int>(i) % workspaces;
+		core.manage(makeClient(i), actions);
+	}
+	core.focusLast();
+	core.commit();
+	backend.clear();
+}
+
+void focusNext() {
+	for(size_t n : Bench::sizes) {
+		MockBackend backend;
+		Metrics metrics;
+		Core core(backend, metrics, MockBackend::atoms(), Config::Move, screen);
+		populate(core, backend, n, 1);
+
+		double ns = Bench::measure(operations, [&](size_t) {
+			core.focusNext();
+			core.commit();
+		});
+		Bench::report("core_focus_next", n, ns);
+		Bench::report("core_focus_next_requests", n,
+				static_cast<double>(backend.requests() ) / operations);
+	}
+}
+
+//The real switch path, hide() and show() included, with half the clients
+//on each of two workspaces. Geometry comes from Client, so the only
+//requests are the moves, maps or container swap themselves.
+void switchWorkspace(const char *name, const char *requestsName, Config::Hiding hiding) {
+	for(size_t n : Bench::sizes) {
+		MockBackend backend;
+		Metrics metrics;
+		Core core(backend, metrics, MockBackend::atoms(), hiding, screen);
+		populate(core, backend, n, 2);
+
+		double ns = Bench::measure(operations, [&](size_t i) {
+			core.switchWorkspace(static_cast<int>( (i + 1) % 2) );
+			core.commit();
+			if(i % 2) backend.clear();	//Keeps the record from growing
+		});
+		Bench::report(name, n, ns);
+
+		backend.clear();
+		core.switchWorkspace(1);
+		core.commit();
+		Bench::report(requestsName, n, static_cast<double>(backend.requests() ) );
+	}
+}
+
+void switchMove() {
+	switchWorkspace("core_switch_move", "core_switch_move_requests", Config::Move);
+}
+
+void switchIconify() {
+	switchWorkspace("core_switch_iconify", "core_switch_iconify_requests", Config::Iconify);
+}
+
+void switchContainer() {
+	switchWorkspace("core_switch_container", "core_switch_container_requests",
+			Config::Container);
+}
+
+//A window mapping and going away again next to n others on a tiled workspace
+void frameErase() {
+	for(size_t n : Bench::sizes) {
+		MockBackend backend;
+		Metrics metrics;
+		Core core(backend, metrics, MockBackend::atoms(), Config::Move, screen);
+		core.setLayout(0, Layout::MasterStack);
+		populate(core, backend, n, 1);
+
+		const Client churned = makeClient(n);
+		const std::vector<Window> windows = {churned.window};
+		double ns = Bench::measure(churns, [&](size_t) {
+			core.manage(churned, {});
+			core.map(windows, windows);
+			core.commit();
+			core.unmanage(*core.find(churned.window) );
+			core.relayout(0);
+			core.commit();
+			backend.clear();
+		});
+		Bench::report("core_frame_erase", n, ns);
+	}
+}
+
+const Bench::Register focusNextCase("core_focus_next", &focusNext);
+const Bench::Register switchMoveCase("core_switch_move", &switchMove);
+const Bench::Register switchIconifyCase("core_switch_iconify", &switchIconify);
+const Bench::Register switchContainerCase("core_switch_container", &switchContainer);
+const Bench::Register frameEraseCase("core_frame_erase", &frameErase);
+
+}
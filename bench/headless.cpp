@@ -0,0 +1,524 @@
+#include "ipc.hpp"
+#include "bench.hpp"
+
+#include <poll.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <pthread.h>
+#include <time.h>
+
+#include <atomic>
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+extern "C" {
+	#include <X11/Xlibint.h>
+	#include <X11/Xatom.h>
+	#include <X11/Xutil.h>
+	#include <X11/keysym.h>
+	#include <X11/extensions/xtestproto.h>
+}
+
+//Xlibint.h leaks these
+#undef min
+#undef max
+
+//End to end latencies of a running wm, seen from the clients it manages.
+//bench/headless.sh starts Xvfb and wm, then runs these with WMBENCH_DRIVE
+//set. They map real windows, so they refuse to run on any other display.
+
+namespace {
+
+constexpr int timeoutMs = 2000;
+constexpr size_t maps = 200;
+constexpr size_t switches = 50;
+constexpr size_t windowCounts[] = {1, 10, 100, 500};
+constexpr size_t motions = 1000;
+constexpr size_t commands = 200;
+constexpr int renderFps = 60;
+constexpr double cpuSeconds = 2;
+
+struct Session {
+	Display *display = nullptr;
+	Window root = None;
+	Atom currentDesktop = None;
+
+	~Session() {
+		if(display) XCloseDisplay(display);
+	}
+
+	//Connects to the display wm runs on, false if the benchmark is skipped
+	bool open(const char *benchmark) {
+		if(!std::getenv("WMBENCH_DRIVE") ) {
+			std::cerr << benchmark << ": needs a wm to drive, run bench/headless.sh\n";
+			return false;
+		}
+
+		std::string reply;
+		if(!Ipc::request("workspace", reply) ) {
+			std::cerr << benchmark << ": no wm listening on " << Ipc::socketPath()
+				<< ", skipped\n";
+			return false;
+		}
+
+		display = XOpenDisplay(nullptr);
+		if(!display) {
+			std::cerr << benchmark << ": no X display, skipped\n";
+			return false;
+		}
+
+		root = DefaultRootWindow(display);
+		currentDesktop = XInternAtom(display, "_NET_CURRENT_DESKTOP", False);
+		XSelectInput(display, root, PropertyChangeMask);
+		return true;
+	}
+
+	//A managed window, reporting its focus and geometry changes
+	Window client(int x, int y) const {
+		Window w = XCreateSimpleWindow(display, root, x, y, 320, 240, 0, 0, 0);
+		XSelectInput(display, w, FocusChangeMask | StructureNotifyMask);
+		return w;
+	}
+
+	//Handles events until match accepts one, false on timeout
+	bool wait(const std::function<bool(const XEvent&)> &match,
+			const std::function<void(const XEvent&)> &other = nullptr) const {
+		const double deadline = Bench::now() + timeoutMs * 1e6;
+		XFlush(display);
+
+		for(;;) {
+			while(XPending(display) ) {
+				XEvent e;
+				XNextEvent(display, &e);
+				if(match(e) ) return true;
+				if(other) other(e);
+			}
+
+			const double left = deadline - Bench::now();
+			if(left <= 0) return false;
+
+			pollfd pfd = {ConnectionNumber(display), POLLIN, 0};
+			poll(&pfd, 1, static_cast<int>(left / 1e6) + 1);
+		}
+	}
+
+	//Row name with the hiding mode wm was started with, told by the map
+	//state of w while its workspace is hidden. Move mode keeps it plain.
+	std::string tagged(const char *name, Window w) const {
+		XWindowAttributes attributes;
+		if(!XGetWindowAttributes(display, w, &attributes) ) return name;
+		switch(attributes.map_state) {
+			case IsUnmapped:
+				return std::string(name) + "_iconify";
+			case IsUnviewable:
+				return std::string(name) + "_container";
+			default:
+				return name;
+		}
+	}
+
+	bool focused(Window w) const {
+		return wait([w](const XEvent &e) {
+			return e.type == FocusIn && e.xfocus.window == w;
+		});
+	}
+};
+
+//XTEST FakeInput, written by hand as libXtst is not a dependency
+class FakeInput {
+	public:
+		bool open(Display *display) {
+			int event, error;
+			_display = display;
+			return XQueryExtension(display, "XTEST", &_opcode, &event, &error);
+		}
+
+		void send(int type, unsigned detail, int x = 0, int y = 0) {
+			Display *dpy = _display;	//Xlibint macros expect 'dpy'
+			xXTestFakeInputReq *req;
+
+			LockDisplay(dpy);
+			GetReq(XTestFakeInput, req);
+			req->reqType = static_cast<CARD8>(_opcode);
+			req->xtReqType = X_XTestFakeInput;
+			req->type = static_cast<BYTE>(type);
+			req->detail = static_cast<BYTE>(detail);
+			req->time = CurrentTime;
+			req->root = None;	//Pointer root
+			req->rootX = static_cast<INT16>(x);
+			req->rootY = static_cast<INT16>(y);
+			req->deviceid = 0;
+			UnlockDisplay(dpy);
+			SyncHandle();
+		}
+
+	private:
+		Display *_display = nullptr;
+		int _opcode = 0;
+};
+
+//MapRequest sent until wm has given the new window input focus
+void mapToFocus() {
+	Session session;
+	if(!session.open("map_to_focus") ) return;
+
+	Bench::Samples samples;
+	for(size_t i = 0; i < maps; i++) {
+		const Window w = session.client(100, 100);
+
+		const double start = Bench::now();
+		XMapWindow(session.display, w);
+		if(!session.focused(w) ) {
+			std::cerr << "map_to_focus: window never got focus\n";
+			break;
+		}
+		samples.push_back(Bench::now() - start);
+
+		XDestroyWindow(session.display, w);
+	}
+
+	Bench::report("map_to_focus", 1, samples);
+}
+
+//"go left"/"go right" over the socket until _NET_CURRENT_DESKTOP changes,
+//which wm only does after every window has been moved
+void workspaceGo() {
+	Session session;
+	if(!session.open("workspace_go") ) return;
+
+	std::vector<Window> windows;
+	for(size_t count : windowCounts) {
+		while(windows.size() < count) {
+			const int i = static_cast<int>(windows.size() );
+			windows.push_back(session.client(i % 64 * 16, i % 48 * 16) );
+			XMapWindow(session.display, windows.back() );
+		}
+
+		//Every pending MapRequest is framed in one batch, focusing the last
+		if(!session.focused(windows.back() ) ) {
+			std::cerr << "workspace_go: windows never got managed\n";
+			break;
+		}
+
+		Bench::Samples samples;
+		std::string reply;
+		std::string name = "workspace_go";
+		for(size_t i = 0; i < switches; i++) {
+			const double start = Bench::now();
+			if(!Ipc::request(i % 2 ? "go right" : "go left", reply) ) break;
+
+			const bool switched = session.wait([&](const XEvent &e) {
+				return e.type == PropertyNotify
+					&& e.xproperty.atom == session.currentDesktop;
+			});
+			if(!switched) break;
+
+			samples.push_back(Bench::now() - start);
+			if(i == 0) name = session.tagged("workspace_go", windows.back() );
+		}
+
+		Bench::report(name.c_str(), count, samples);
+	}
+
+	for(Window w : windows) {
+		XDestroyWindow(session.display, w);
+	}
+	XSync(session.display, False);
+}
+
+//Alt + Button1 drag with one motion event per millisecond, a 1000 Hz mouse.
+//ns_per_op is the wall time per motion event until the window lands, the
+//percentiles are the intervals between the moves wm actually sent.
+void dragMove() {
+	Session session;
+	if(!session.open("drag_move") ) return;
+
+	FakeInput input;
+	if(!input.open(session.display) ) {
+		std::cerr << "drag_move: no XTEST extension, skipped\n";
+		return;
+	}
+
+	const Window w = session.client(100, 100);
+	XMapWindow(session.display, w);
+	if(!session.focused(w) ) {
+		std::cerr << "drag_move: window never got focus\n";
+		return;
+	}
+
+	const KeyCode alt = XKeysymToKeycode(session.display, XK_Alt_L);
+	const int startX = 200, startY = 200;
+	const int endX = startX + static_cast<int>(motions / 4);
+	const int endY = startY + static_cast<int>(motions / 8);
+	auto isMove = [w](const XEvent &e) {
+		return e.type == ConfigureNotify && e.xconfigure.window == w;
+	};
+
+	input.send(MotionNotify, 0, startX, startY);
+	input.send(KeyPress, alt);
+	input.send(ButtonPress, Button1);
+	XSync(session.display, False);
+
+	Bench::Samples samples;
+	double lastMove = Bench::now();
+	auto onMove = [&](const XEvent &e) {
+		if(!isMove(e) ) return;
+		const double t = Bench::now();
+		samples.push_back(t - lastMove);
+		lastMove = t;
+	};
+
+	const double start = Bench::now();
+	for(size_t i = 1; i <= motions; i++) {
+		input.send(MotionNotify, 0,
+				startX + static_cast<int>(i / 4),
+				startY + static_cast<int>(i / 8) );
+		XFlush(session.display);
+
+		const double due = start + static_cast<double>(i) * 1e6;
+		for(double left = due - Bench::now(); left > 0; left = due - Bench::now() ) {
+			while(XPending(session.display) ) {
+				XEvent e;
+				XNextEvent(session.display, &e);
+				onMove(e);
+			}
+			pollfd pfd = {ConnectionNumber(session.display), POLLIN, 0};
+			poll(&pfd, 1, static_cast<int>(left / 1e6) );
+		}
+	}
+
+	input.send(ButtonRelease, Button1);
+	input.send(KeyRelease, alt);
+
+	//The release is applied exactly, whatever pacing skipped
+	const int landX = 100 + endX - startX, landY = 100 + endY - startY;
+	const bool landed = session.wait([&](const XEvent &e) {
+		return isMove(e) && e.xconfigure.x == landX && e.xconfigure.y == landY;
+	}, onMove);
+	if(!landed) {
+		std::cerr << "drag_move: window never landed\n";
+	}
+
+	const double elapsed = Bench::now() - start;
+	Bench::report("drag_move", motions, samples);
+	Bench::report("drag_move_total", motions, elapsed / static_cast<double>(motions) );
+
+	XDestroyWindow(session.display, w);
+	XSync(session.display, False);
+}
+
+//wmevent as a shell or hotkey daemon runs it, process startup included,
+//next to the same command sent from this process
+void wmeventCommand() {
+	Session session;
+	if(!session.open("wmevent_command") ) return;
+
+	const char *wmevent = std::getenv("WMEVENT");
+	if(!wmevent) wmevent = "./wmevent";
+	char *argv[] = {const_cast<char*>("wmevent"), const_cast<char*>("focusnext"), nullptr};
+
+	posix_spawn_file_actions_t actions;
+	posix_spawn_file_actions_init(&actions);
+	posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+
+	Bench::Samples samples;
+	for(size_t i = 0; i < commands; i++) {
+		const double start = Bench::now();
+		pid_t pid;
+		int status;
+		if(posix_spawn(&pid, wmevent, &actions, nullptr, argv, environ) != 0
+				|| waitpid(pid, &status, 0) < 0
+				|| !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+			std::cerr << "wmevent_command: " << wmevent << " failed\n";
+			break;
+		}
+		samples.push_back(Bench::now() - start);
+	}
+	posix_spawn_file_actions_destroy(&actions);
+	Bench::report("wmevent_command", 1, samples);
+
+	samples.clear();
+	std::string reply;
+	for(size_t i = 0; i < commands; i++) {
+		const double start = Bench::now();
+		if(!Ipc::request("focusnext", reply) ) break;
+		samples.push_back(Bench::now() - start);
+	}
+	Bench::report("ipc_command", 1, samples);
+}
+
+//Stand-in for a browser or video player: draws a software rendered frame
+//at renderFps while it is visible and stops once it is unmapped or marked
+//_NET_WM_STATE_HIDDEN, like Chromium based clients do.
+class Renderer {
+	public:
+		~Renderer() {
+			_stop = true;
+			if(_thread.joinable() ) _thread.join();
+			if(_display) XCloseDisplay(_display);
+		}
+
+		//Creates the window, left unmapped until start()
+		bool open() {
+			_display = XOpenDisplay(nullptr);
+			if(!_display) return false;
+
+			_netState = XInternAtom(_display, "_NET_WM_STATE", False);
+			_hidden = XInternAtom(_display, "_NET_WM_STATE_HIDDEN", False);
+			_window = XCreateSimpleWindow(_display, DefaultRootWindow(_display),
+					100, 100, width, height, 0, 0, 0);
+			XSelectInput(_display, _window, StructureNotifyMask | PropertyChangeMask);
+			XSync(_display, False);
+			return true;
+		}
+
+		void start() {
+			XMapWindow(_display, _window);
+			XFlush(_display);
+			_thread = std::thread(&Renderer::run, this);
+		}
+
+		Window window() const {
+			return _window;
+		}
+
+		//CPU time the render thread has used so far, in nanoseconds
+		double cpu() {
+			clockid_t clock;
+			timespec ts = {};
+			pthread_getcpuclockid(_thread.native_handle(), &clock);
+			clock_gettime(clock, &ts);
+			return static_cast<double>(ts.tv_sec) * 1e9 + static_cast<double>(ts.tv_nsec);
+		}
+
+	private:
+		constexpr static unsigned int width = 640, height = 480;
+
+		void run() {
+			Visual *visual = DefaultVisual(_display, DefaultScreen(_display) );
+			const int depth = DefaultDepth(_display, DefaultScreen(_display) );
+			std::vector<uint32_t> pixels(width * height);
+			XImage *image = XCreateImage(_display, visual, static_cast<unsigned>(depth),
+					ZPixmap, 0, reinterpret_cast<char*>(pixels.data() ), width, height, 32, 0);
+			GC gc = XCreateGC(_display, _window, 0, nullptr);
+
+			bool mapped = false, hidden = false;
+			double next = Bench::now();
+			for(uint32_t frame = 0; !_stop; frame++) {
+				while(XPending(_display) ) {
+					XEvent e;
+					XNextEvent(_display, &e);
+					if(e.type == MapNotify) mapped = true;
+					if(e.type == UnmapNotify) mapped = false;
+					if(e.type == PropertyNotify && e.xproperty.atom == _netState) {
+						hidden = stateHidden();
+					}
+				}
+
+				if(mapped && !hidden) {
+					for(uint32_t y = 0; y < height; y++) {
+						for(uint32_t x = 0; x < width; x++) {
+							pixels[y * width + x] = (x + frame) * 0x010203u ^ (y - frame) * 0x030201u;
+						}
+					}
+					XPutImage(_display, _window, gc, image, 0, 0, 0, 0, width, height);
+					XFlush(_display);
+				}
+
+				next += 1e9 / renderFps;
+				const double left = next - Bench::now();
+				pollfd pfd = {ConnectionNumber(_display), POLLIN, 0};
+				if(left > 0) poll(&pfd, 1, static_cast<int>(left / 1e6) );
+			}
+
+			image->data = nullptr;	//Owned by pixels
+			XDestroyImage(image);
+			XFreeGC(_display, gc);
+		}
+
+		bool stateHidden() const {
+			Atom type;
+			int format;
+			unsigned long n, after;
+			unsigned char *data = nullptr;
+			bool found = false;
+
+			if(XGetWindowProperty(_display, _window, _netState, 0, 32, False, XA_ATOM,
+						&type, &format, &n, &after, &data) == Success && data) {
+				const Atom *atoms = reinterpret_cast<const Atom*>(data);
+				found = std::find(atoms, atoms + n, _hidden) != atoms + n;
+			}
+			if(data) XFree(data);
+			return found;
+		}
+
+		Display *_display = nullptr;
+		Window _window = None;
+		Atom _netState = None, _hidden = None;
+		std::atomic<bool> _stop{false};
+		std::thread _thread;
+};
+
+//CPU time a self-throttling client burns per second while its workspace is
+//hidden, next to the same while it is shown. The row name says which
+//hiding mode the wm under test was started with.
+void hiddenCpu() {
+	Session session;
+	if(!session.open("hidden_cpu") ) return;
+
+	Renderer renderer;
+	if(!renderer.open() ) {
+		std::cerr << "hidden_cpu: renderer has no display, skipped\n";
+		return;
+	}
+	XSelectInput(session.display, renderer.window(), FocusChangeMask);
+	XSync(session.display, False);
+	renderer.start();
+	if(!session.focused(renderer.window() ) ) {
+		std::cerr << "hidden_cpu: window never got focus\n";
+		return;
+	}
+
+	auto measure = [&]() {
+		const double cpu = renderer.cpu(), wall = Bench::now();
+		const double until = wall + cpuSeconds * 1e9;
+		while(Bench::now() < until) poll(nullptr, 0, 50);
+		return (renderer.cpu() - cpu) / (Bench::now() - wall) * 1e9;
+	};
+
+	auto go = [&](const char *command) {
+		std::string reply;
+		return Ipc::request(command, reply) && session.wait([&](const XEvent &e) {
+			return e.type == PropertyNotify && e.xproperty.atom == session.currentDesktop;
+		});
+	};
+
+	const double shown = measure();
+	if(!go("go right") ) {
+		std::cerr << "hidden_cpu: workspace never switched\n";
+		return;
+	}
+
+	const std::string name = session.tagged("hidden_cpu", renderer.window() );
+	const double hidden = measure();
+	go("go left");
+
+	Bench::report("shown_cpu", 1, shown);
+	Bench::report(name.c_str(), 1, hidden);
+}
+
+const Bench::Register mapToFocusCase("map_to_focus", &mapToFocus);
+const Bench::Register workspaceGoCase("workspace_go", &workspaceGo);
+const Bench::Register dragMoveCase("drag_move", &dragMove);
+const Bench::Register wmeventCommandCase("wmevent_command", &wmeventCommand);
+const Bench::Register hiddenCpuCase("hidden_cpu", &hiddenCpu);
+
+}
@@ -0,0 +1,75 @@
+#!/bin/sh
+#Runs the wm driving benchmarks against a fresh wm on a private Xvfb
+#display, so results from different commits can be compared.
+#Usage: bench/headless.sh [-j] [benchmark...]
+#Skips when Xvfb is not installed. WM, WMEVENT and WMBENCH override the
+#binaries used, for comparing against another checkout, WMFLAGS is passed
+#on to wm.
+
+WM=${WM:-./wm}
+WMEVENT=${WMEVENT:-./wmevent}
+WMBENCH=${WMBENCH:-./bin/wmbench}
+export WMEVENT
+
+XVFB=$(command -v Xvfb)
+if [ -z "$XVFB" ]; then
+	echo "headless: Xvfb not found, skipped" >&2
+	exit 0
+fi
+
+json=
+if [ "$1" = "-j" ]; then
+	json=-j
+	shift
+fi
+if [ $# -eq 0 ]; then
+	set -- map_to_focus workspace_go drag_move wmevent_command hidden_cpu
+fi
+
+tmp=$(mktemp -d)
+XDG_RUNTIME_DIR=$tmp
+export XDG_RUNTIME_DIR
+
+cleanup() {
+	[ -n "$wm" ] && kill "$wm" 2>/dev/null
+	[ -n "$xvfb" ] && kill "$xvfb" 2>/dev/null
+	wait 2>/dev/null
+	rm -rf "$tmp"
+}
+trap cleanup EXIT
+trap 'exit 1' INT TERM
+
+#Xvfb picks a free display and writes its number once it accepts clients
+"$XVFB" -displayfd 3 -screen 0 1920x1080x24 -nolisten tcp \
+	3>"$tmp/display" 2>"$tmp/xvfb.log" &
+xvfb=$!
+
+tries=50
+while [ ! -s "$tmp/display" ]; do
+	tries=$((tries - 1))
+	if [ $tries -eq 0 ]; then
+		echo "headless: Xvfb did not start, see below" >&2
+		cat "$tmp/xvfb.log" >&2
+		exit 1
+	fi
+	sleep 0.1
+done
+
+DISPLAY=:$(cat "$tmp/display")
+export DISPLAY
+
+"$WM" $WMFLAGS 2>"$tmp/wm.log" &
+wm=$!
+
+tries=50
+until "$WMEVENT" workspace >/dev/null 2>&1; do
+	tries=$((tries - 1))
+	if [ $tries -eq 0 ]; then
+		echo "headless: wm did not start, see below" >&2
+		cat "$tmp/wm.log" >&2
+		exit 1
+	fi
+	sleep 0.1
+done
+
+WMBENCH_DRIVE=1 "$WMBENCH" $json "$@"
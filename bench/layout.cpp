@@ -0,0 +1,83 @@
+#include "core.hpp"
+#include "mock_backend.hpp"
+#include "bench.hpp"
+
+#include <algorithm>
+#include <string>
+
+//Cost of Core::relayout() for one tiled workspace, against MockBackend so
+//the requests are counted instead of sent. "churn" frames and unmanages
+//one more client in turn, which shifts every stack or grid tile; "steady"
+//recomputes a settled workspace, where the diff against the sent geometry
+//has to find that nothing needs sending. The configures_* rows report how
+//many configures one churn hands the backend, in place of a time.
+
+namespace {
+
+constexpr size_t relayouts = 1 << 14;
+const Vector2 screen = {2560, 1440};
+
+Client makeClient(Window w) {
+	Client client;
+	client.window = w;
+	client.workspace = 0;
+	client.size = {320, 240};
+	client.sentSize = client.size;
+	client.mapped = true;
+	return client;
+}
+
+void run(const char *name, Layout::Mode mode) {
+	const std::string churn = std::string(name) + "_churn";
+	const std::string steady = std::string(name) + "_steady";
+	const std::string configures = std::string("configures_") + name + "_churn";
+
+	for(size_t n : Bench::sizes) {
+		MockBackend backend;
+		Metrics metrics;
+		Core core(backend, metrics, MockBackend::atoms(), Config::Move, screen);
+		core.setLayout(0, mode);
+		for(size_t i = 0; i < n; i++) core.manage(makeClient(i + 1), {});
+		core.relayout(0);
+		core.commitGeometry();
+		backend.clear();
+
+		const Client extra = makeClient(n + 1);
+		size_t sent = 0;
+		const size_t iterations = std::max<size_t>(relayouts / n, 64);
+
+		double ns = Bench::measure(iterations, [&](size_t i) {
+			if(i % 2) {
+				core.unmanage(*core.find(extra.window) );	//Lays out what is left
+			} else {
+				core.manage(extra, {});
+				core.relayout(0);
+			}
+			core.commitGeometry();
+			sent += backend.count(MockBackend::Configure);
+			backend.clear();
+		});
+		Bench::report(churn.c_str(), n, ns);
+		Bench::report(configures.c_str(), n,
+				static_cast<double>(sent) / static_cast<double>(iterations) );
+
+		ns = Bench::measure(iterations, [&](size_t) {
+			core.relayout(0);
+			core.commitGeometry();
+		});
+		Bench::report(steady.c_str(), n, ns);
+	}
+}
+
+void masterStack() {
+	run("layout_master", Layout::MasterStack);
+}
+
+void grid() {
+	run("layout_grid", Layout::Grid);
+}
+
+const Bench::Register masterStackCase("layout_master", &masterStack);
+const Bench::Register gridCase("layout_grid", &grid);
+
+}
@@ -0,0 +1,139 @@
+#include "bench.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Entry {
+	const char *name;
+	Bench::Run run;
+};
+
+struct Row {
+	std::string benchmark;
+	size_t n;
+	double nsPerOp;
+	bool hasPercentiles;
+	double p50, p90, p99, max;
+};
+
+std::vector<Entry> &registry() {
+	static std::vector<Entry> entries;
+	return entries;
+}
+
+std::vector<Row> rows;
+bool json = false;
+
+void print(std::ostream &out, const Row &row) {
+	if(json) {
+		out << "{\"benchmark\":\"" << row.benchmark << "\",\"n\":" << row.n
+			<< ",\"ns_per_op\":" << row.nsPerOp;
+		if(row.hasPercentiles) {
+			out << ",\"p50_ns\":" << row.p50 << ",\"p90_ns\":" << row.p90
+				<< ",\"p99_ns\":" << row.p99 << ",\"max_ns\":" << row.max;
+		}
+		out << '}';
+		return;
+	}
+
+	out << row.benchmark << ',' << row.n << ',' << row.nsPerOp;
+	if(row.hasPercentiles) {
+		out << ',' << row.p50 << ',' << row.p90 << ',' << row.p99 << ',' << row.max;
+	} else {
+		out << ",,,,";
+	}
+	out << '\n';
+}
+
+//Nearest rank, samples must be sorted
+double percentile(const Bench::Samples &samples, double q) {
+	const size_t rank = static_cast<size_t>(
+			std::max(1.0, std::ceil(q * static_cast<double>(samples.size() ) ) ) ) - 1;
+	return samples[std::min(rank, samples.size() - 1)];
+}
+
+}
+
+Bench::Register::Register(const char *name, Run run) {
+	registry().push_back({name, run});
+}
+
+double Bench::measure(size_t iterations, const std::function<void(size_t)> &op) {
+	const double start = now();
+	for(size_t i = 0; i < iterations; i++) {
+		op(i);
+	}
+	const double stop = now();
+
+	return (stop - start) / static_cast<double>(iterations);
+}
+
+double Bench::now() {
+	using Clock = std::chrono::steady_clock;
+	return std::chrono::duration<double, std::nano>(
+			Clock::now().time_since_epoch() ).count();
+}
+
+void Bench::report(const char *benchmark, size_t n, double nsPerOp) {
+	rows.push_back({benchmark, n, nsPerOp, false, 0, 0, 0, 0});
+	if(!json) print(std::cout, rows.back() );
+}
+
+void Bench::report(const char *benchmark, size_t n, Samples &samples) {
+	if(samples.empty() ) return;
+
+	std::sort(samples.begin(), samples.end() );
+	const double mean = std::accumulate(samples.begin(), samples.end(), 0.0)
+		/ static_cast<double>(samples.size() );
+
+	rows.push_back({benchmark, n, mean, true, 
+			percentile(samples, 0.50), 
+			percentile(samples, 0.90),
+			percentile(samples, 0.99), 
+			samples.back()});
+	if(!json) print(std::cout, rows.back() );
+}
+
+//Runs every registered benchmark, or only those named on the command line.
+//CSV rows are printed as they come in, JSON once everything has run.
+int main(int argc, char **argv) {
+	int first = 1;
+	if(argc > 1 && std::strcmp(argv[1], "-j") == 0) {
+		json = true;
+		first++;
+	}
+
+	if(!json) {
+		std::cout << "benchmark,n,ns_per_op,p50_ns,p90_ns,p99_ns,max_ns\n";
+	}
+
+	for(const auto &entry : registry() ) {
+		bool selected = argc == first;
+		for(int i = first; i < argc; i++) {
+			selected |= std::strcmp(argv[i], entry.name) == 0;
+		}
+
+		if(selected) entry.run();
+	}
+
+	if(json) {
+		std::cout << "[\n";
+		for(size_t i = 0; i < rows.size(); i++) {
+			std::cout << "\t";
+			print(std::cout, rows[i]);
+			std::cout << (i + 1 < rows.size() ? ",\n" : "\n");
+		}
+		std::cout << "]\n";
+	}
+
+	return EXIT_SUCCESS;
+}
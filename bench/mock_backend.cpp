@@ -0,0 +1,102 @@
+#include "mock_backend.hpp"
+
+const NetAtom &MockBackend::atoms() {
+	static const NetAtom atoms = []() {
+		NetAtom fake{};
+		fake.WMStateHidden = 1;
+		return fake;
+	}();
+	return atoms;
+}
+
+void MockBackend::configure(Window w, unsigned int mask, Vector2 position, Vector2 size) {
+	record(Configure, w);
+}
+
+void MockBackend::notify(Window w, Vector2 position, Vector2 size) {
+	record(Notify, w);
+}
+
+void MockBackend::map(Window w) {
+	record(Map, w);
+}
+
+void MockBackend::unmap(Window w) {
+	record(Unmap, w);
+}
+
+void MockBackend::raise(Window w) {
+	record(Raise, w);
+}
+
+void MockBackend::focus(Window w) {
+	record(Focus, w);
+}
+
+void MockBackend::reparent(Window w, Window parent, Vector2 position) {
+	record(Reparent, w);
+}
+
+void MockBackend::saveSet(Window w, bool add) {
+	record(SaveSet, w);
+}
+
+void MockBackend::setState(Window w, long state, const std::vector<Atom> &netState) {
+	record(SetState, w);
+}
+
+void MockBackend::setDesktop(Window w, int workspace) {
+	record(SetDesktop, w);
+}
+
+void MockBackend::setCurrentDesktop(int workspace) {
+	record(SetCurrentDesktop, None);
+}
+
+void MockBackend::setActiveWindow(Window w) {
+	record(SetActiveWindow, w);
+}
+
+void MockBackend::setList(List list, const Window *windows, size_t n, bool append) {
+	record(SetList, None);
+}
+
+Window MockBackend::createContainer() {
+	const Window container = _nextContainer++;
+	record(CreateContainer, container);
+	return container;
+}
+
+unsigned long MockBackend::nextRequest() {
+	return _serial;
+}
+
+void MockBackend::noOp() {
+	record(NoOp, None);
+}
+
+void MockBackend::flush() {
+}
+
+const std::vector<MockBackend::Call> &MockBackend::calls() const {
+	return _calls;
+}
+
+size_t MockBackend::count(Kind kind) const {
+	return _counts[kind];
+}
+
+size_t MockBackend::requests() const {
+	return _calls.size();
+}
+
+void MockBackend::clear() {
+	_calls.clear();
+	_counts.fill(0);
+}
+
+void MockBackend::record(Kind kind, Window w) {
+	_calls.push_back({kind, w});
+	_counts[kind]++;
+	_serial++;
+}
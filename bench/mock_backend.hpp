@@ -0,0 +1,78 @@
+#pragma once
+#ifndef MOCK_BACKEND_HPP
+#define MOCK_BACKEND_HPP
+
+#include "backend.hpp"
+#include "atoms.hpp"
+
+#include <array>
+#include <vector>
+
+//Backend that only writes down what it was asked, so Core can be driven
+//and measured without an X server. Serials advance by one per request.
+class MockBackend : public Backend {
+	public:
+		//No server interns them, _NET_WM_STATE_HIDDEN only needs to be
+		//told apart from the atoms clients set
+		static const NetAtom &atoms();
+
+		enum Kind {
+			Configure = 0,
+			Notify,
+			Map,
+			Unmap,
+			Raise,
+			Focus,
+			Reparent,
+			SaveSet,
+			SetState,
+			SetDesktop,
+			SetCurrentDesktop,
+			SetActiveWindow,
+			SetList,
+			CreateContainer,
+			NoOp,
+			NKinds
+		};
+
+		struct Call {
+			Kind kind;
+			Window window;
+		};
+
+		void configure(Window w, unsigned int mask, Vector2 position, Vector2 size) override;
+		void notify(Window w, Vector2 position, Vector2 size) override;
+		void map(Window w) override;
+		void unmap(Window w) override;
+		void raise(Window w) override;
+		void focus(Window w) override;
+		void reparent(Window w, Window parent, Vector2 position) override;
+		void saveSet(Window w, bool add) override;
+		void setState(Window w, long state, const std::vector<Atom> &netState) override;
+		void setDesktop(Window w, int workspace) override;
+		void setCurrentDesktop(int workspace) override;
+		void setActiveWindow(Window w) override;
+		void setList(List list, const Window *windows, size_t n, bool append) override;
+		Window createContainer() override;
+
+		unsigned long nextRequest() override;
+		void noOp() override;
+		void flush() override;
+
+		const std::vector<Call> &calls() const;
+		//Requests of kind since the last clear()
+		size_t count(Kind kind) const;
+		size_t requests() const;
+		//Forgets the calls, serials and container ids keep going
+		void clear();
+
+	private:
+		void record(Kind kind, Window w);
+
+		std::vector<Call> _calls;
+		std::array<size_t, NKinds> _counts{};
+		unsigned long _serial = 1;
+		Window _nextContainer = 0x100001;	//Clear of the ids benchmarks use
+};
+
+#endif
@@ -0,0 +1,67 @@
+#!/bin/sh
+#Plays traces taken with "wm -T FILE" through wmreplay, each on a fresh
+#private Xvfb display, so a recorded session becomes a benchmark that gives
+#the same handler work on every commit.
+#Usage: bench/replay.sh [-p] [-j] trace...
+#Prints wmreplay's CSV row per trace. Skips when Xvfb is not installed or
+#there is no trace. WMREPLAY overrides the binary used, WMFLAGS is passed on
+#to the wm and should match what the trace was taken with.
+
+WMREPLAY=${WMREPLAY:-./wmreplay}
+
+XVFB=$(command -v Xvfb)
+if [ -z "$XVFB" ]; then
+	echo "replay: Xvfb not found, skipped" >&2
+	exit 0
+fi
+
+flags=
+while [ "$1" = "-p" ] || [ "$1" = "-j" ]; do
+	flags="$flags $1"
+	shift
+done
+if [ $# -eq 0 ]; then
+	echo "replay: no trace given, skipped" >&2
+	exit 0
+fi
+
+tmp=$(mktemp -d)
+XDG_RUNTIME_DIR=$tmp
+export XDG_RUNTIME_DIR
+
+cleanup() {
+	[ -n "$xvfb" ] && kill "$xvfb" 2>/dev/null
+	wait 2>/dev/null
+	rm -rf "$tmp"
+}
+trap cleanup EXIT
+trap 'exit 1' INT TERM
+
+status=0
+echo "trace,events,commands,frames,batches,handler_ns,wall_ns,requests,round_trips"
+for trace in "$@"; do
+	#Xvfb picks a free display and writes its number once it accepts clients
+	rm -f "$tmp/display"
+	"$XVFB" -displayfd 3 -screen 0 1920x1080x24 -nolisten tcp \
+		3>"$tmp/display" 2>"$tmp/xvfb.log" &
+	xvfb=$!
+
+	tries=50
+	while [ ! -s "$tmp/display" ]; do
+		tries=$((tries - 1))
+		if [ $tries -eq 0 ]; then
+			echo "replay: Xvfb did not start, see below" >&2
+			cat "$tmp/xvfb.log" >&2
+			exit 1
+		fi
+		sleep 0.1
+	done
+
+	DISPLAY=:$(cat "$tmp/display") "$WMREPLAY" "$trace" $flags $WMFLAGS || status=1
+
+	kill "$xvfb" 2>/dev/null
+	wait "$xvfb" 2>/dev/null
+	xvfb=
+done
+
+exit $status
@@ -0,0 +1,55 @@
+#include "rules.hpp"
+#include "bench.hpp"
+
+#include <string>
+#include <vector>
+
+//frame() matches every new window against the rules. Matching is one hash
+//lookup per combination of matchers in use, so it should stay flat as the
+//rule count grows. Half the lookups hit, half miss.
+
+namespace {
+
+constexpr size_t matches = 1 << 20;
+
+int workspace(std::string_view name) {
+	return name == "north" ? 3 : -1;
+}
+
+void rulesMatch() {
+	for(size_t n : Bench::sizes) {
+		//Class only, class + type and title rules, as a real file mixes them
+		std::string text;
+		for(size_t i = 0; i < n; i++) {
+			const std::string id = std::to_string(i);
+			switch(i % 3) {
+				case 0: text += "class=app" + id + " workspace=north\n"; break;
+				case 1: text += "class=app" + id + " type=dialog float\n"; break;
+				case 2: text += "title=\"Window " + id + "\" zoom\n"; break;
+			}
+		}
+
+		Rules rules;
+		std::string error;
+		rules.compile(text, &workspace, error);
+
+		std::vector<std::string> classes, titles;
+		for(size_t i = 0; i < n * 2; i++) {
+			classes.push_back("app" + std::to_string(i) );
+			titles.push_back("Window " + std::to_string(i) );
+		}
+
+		volatile int sink = 0;
+		double ns = Bench::measure(matches, [&](size_t i) {
+			const size_t w = i % classes.size();
+			const auto actions = rules.match({classes[w], "app", titles[w], "dialog"});
+			sink += actions.workspace + actions.floating + actions.zoom;
+		});
+
+		Bench::report("rules_match", n, ns);
+	}
+}
+
+const Bench::Register rulesMatchCase("rules_match", &rulesMatch);
+
+}
@@ -0,0 +1,52 @@
+#!/bin/sh
+#Training run for the profile guided release, see pgo in makefile. Drives
+#the instrumented wm and wmevent through bench/headless.sh once per hiding
+#mode: windows mapping and going away, workspace switches, drags and
+#wmevent spawned for every command, queries included. Both write their
+#profile as they exit.
+#Usage: bench/train.sh
+#Fails when Xvfb is not installed, a release without a profile is not what
+#was asked for. WM and WMEVENT default to the instrumented release binaries.
+
+WM=${WM:-./bin/wm-release}
+WMEVENT=${WMEVENT:-./bin/wmevent-release}
+export WM WMEVENT
+
+#Run by headless.sh in place of wmbench, with DISPLAY set and wm up
+if [ -n "$WMTRAIN_DRIVE" ]; then
+	"$WMTRAIN_BENCH" map_to_focus workspace_go drag_move wmevent_command >/dev/null || exit 1
+
+	i=0
+	while [ $i -lt 20 ]; do
+		for dir in left right up down; do
+			"$WMEVENT" go $dir
+			"$WMEVENT" move $dir
+		done
+		for layout in master grid float; do
+			"$WMEVENT" layout $layout
+		done
+		"$WMEVENT" focusnext
+		"$WMEVENT" focusprev
+		"$WMEVENT" zoom
+		for query in focused clients workspace stats; do
+			"$WMEVENT" $query >/dev/null
+		done
+		"$WMEVENT" -h >/dev/null
+		i=$((i + 1))
+	done
+	exit 0
+fi
+
+if [ -z "$(command -v Xvfb)" ]; then
+	echo "train: Xvfb not found, no profile written" >&2
+	exit 1
+fi
+
+WMTRAIN_BENCH=${WMBENCH:-./bin/wmbench}
+WMTRAIN_DRIVE=1
+WMBENCH=$0
+export WMTRAIN_BENCH WMTRAIN_DRIVE WMBENCH
+
+for hiding in move iconify container; do
+	WMFLAGS="-H $hiding" ./bench/headless.sh || exit 1
+done
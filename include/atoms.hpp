@@ -6,18 +6,26 @@ extern "C" {
 	#include <X11/Xlib.h>
 }
 
-struct IccAtom {
-	IccAtom(Display *display);
+#include <cstddef>
+
+//Every struct below is a plain sequence of Atoms, with the names to intern
+//listed in member order. internAtoms() fills all of them at once.
 
+struct IccAtom {
 	//Sources for icccm atoms:
 	//https://www.x.org/docs/ICCCM/icccm.pdf
 	Atom DeleteWindow;
 	Atom WMProtocols;
+	Atom WMState;
+
+	constexpr static const char *names[] = {
+		"WM_DELETE_WINDOW",
+		"WM_PROTOCOLS",
+		"WM_STATE"
+	};
 };
 
 struct NetAtom {
-	NetAtom(Display *display);
-
 	size_t size() const;
 	//Further sources
 	//https://specifications.freedesktop.org/wm-spec/1.3/ar01s03.html
@@ -25,20 +33,58 @@ struct NetAtom {
 	Atom activeWindow;
 	Atom numberOfDesktops;
 	Atom currentDesktop;
+	Atom desktopNames;
+	Atom clientList;
+	Atom clientListStacking;
 	Atom WMCheck;
 	Atom WMName;
+	Atom WMDesktop;
 	Atom WMWindowType;
 	Atom WMWindowDock;
 	Atom WMWindowToolbar;
 	Atom WMWindowUtility;
 	Atom WMWindowDialog;
 	Atom WMWindowMenu;
+	Atom WMWindowNormal;
+	Atom WMWindowSplash;
+	Atom WMState;
+	Atom WMStateHidden;
+
+	constexpr static const char *names[] = {
+		"_NET_SUPPORTED",
+		"_NET_ACTIVE_WINDOW",
+		"_NET_NUMBER_OF_DESKTOPS",
+		"_NET_CURRENT_DESKTOP",
+		"_NET_DESKTOP_NAMES",
+		"_NET_CLIENT_LIST",
+		"_NET_CLIENT_LIST_STACKING",
+		"_NET_SUPPORTING_WM_CHECK",
+		"_NET_WM_NAME",
+		"_NET_WM_DESKTOP",
+		"_NET_WM_WINDOW_TYPE",
+		"_NET_WM_WINDOW_TYPE_DOCK",
+		"_NET_WM_WINDOW_TYPE_TOOLBAR",
+		"_NET_WM_WINDOW_TYPE_UTILITY",
+		"_NET_WM_WINDOW_TYPE_DIALOG",
+		"_NET_WM_WINDOW_TYPE_MENU",
+		"_NET_WM_WINDOW_TYPE_NORMAL",
+		"_NET_WM_WINDOW_TYPE_SPLASH",
+		"_NET_WM_STATE",
+		"_NET_WM_STATE_HIDDEN"
+	};
 };
 
 struct OtherAtom {
-	OtherAtom(Display *display);
-
 	Atom utf8str;
+	Atom wmRequest;
+
+	constexpr static const char *names[] = {
+		"UTF8_STRING",
+		"WM_REQUEST"
+	};
 };
 
+//Interns the atoms of all structs above in one XInternAtoms round-trip
+void internAtoms(Display *display, NetAtom &net, IccAtom &icc, OtherAtom &other);
+
 #endif
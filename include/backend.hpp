@@ -0,0 +1,57 @@
+#pragma once
+#ifndef BACKEND_HPP
+#define BACKEND_HPP
+
+extern "C" {
+	#include <X11/Xlib.h>
+}
+
+#include "vector2.hpp"
+
+#include <cstddef>
+#include <vector>
+
+//Everything Core asks of the display. XBackend sends it to the X server,
+//MockBackend in bench/ records it, so the core runs without a server.
+//Windows, atoms and masks are plain X protocol values either way.
+class Backend {
+	public:
+		//Root window properties listing clients
+		enum List {
+			ClientList = 0,
+			ClientListStacking
+		};
+
+		virtual ~Backend() = default;
+
+		//Only the CWX, CWY, CWWidth and CWHeight fields in mask are sent
+		virtual void configure(Window w, unsigned int mask, Vector2 position, Vector2 size) = 0;
+		//Synthetic ConfigureNotify telling w where it is
+		virtual void notify(Window w, Vector2 position, Vector2 size) = 0;
+		virtual void map(Window w) = 0;
+		virtual void unmap(Window w) = 0;
+		virtual void raise(Window w) = 0;
+		//Input focus, None gives it to the root window
+		virtual void focus(Window w) = 0;
+		//Into parent at position, None is the root window
+		virtual void reparent(Window w, Window parent, Vector2 position) = 0;
+		virtual void saveSet(Window w, bool add) = 0;
+		//WM_STATE and _NET_WM_STATE, as Core keeps them
+		virtual void setState(Window w, long state, const std::vector<Atom> &netState) = 0;
+		//_NET_WM_DESKTOP, deleted for a negative workspace
+		virtual void setDesktop(Window w, int workspace) = 0;
+		virtual void setCurrentDesktop(int workspace) = 0;
+		//_NET_ACTIVE_WINDOW, deleted for None
+		virtual void setActiveWindow(Window w) = 0;
+		virtual void setList(List list, const Window *windows, size_t n, bool append) = 0;
+		//Screen sized, unmapped and below every other window
+		virtual Window createContainer() = 0;
+
+		//Serial the next request will get, events carry the one they followed
+		virtual unsigned long nextRequest() = 0;
+		//A request doing nothing, only to put a serial on a point in time
+		virtual void noOp() = 0;
+		virtual void flush() = 0;
+};
+
+#endif
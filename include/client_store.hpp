@@ -0,0 +1,90 @@
+#pragma once
+#ifndef CLIENT_STORE_HPP
+#define CLIENT_STORE_HPP
+
+extern "C" {
+	#include <X11/Xlib.h>
+}
+
+#include "properties.hpp"
+#include "slot_map.hpp"
+#include "vector2.hpp"
+
+#include <unordered_map>
+#include <vector>
+
+struct Client {
+	Window window;		//Handle to window
+	int workspace;		//Workspace index
+	Vector2 restore;	//Coordinates to return to when unzoomed
+	Vector2 restoreSize;	//Dimension to return to when unzoomed
+	Vector2 size;		//Dimension, kept current from ConfigureNotify
+	Vector2 position;	//Positon on its workspace, even while hidden
+	Vector2 sentPosition;	//Last geometry asked of the server, hidden offset included
+	Vector2 sentSize;
+	unsigned long sentSerial = 0;	//Of the last move or resize, older ConfigureNotify is stale
+	bool geometryDirty = false;	//position or size still to be sent, see commit()
+	bool notify = false;	//Owed a ConfigureNotify, synthetic unless resized
+	bool fullscreen = false;
+	bool floating = false;	//Kept out of tiling layouts
+	bool mapped = false;	//Mapped by wm, or already when adopted
+	bool iconic = false;	//Unmapped by hide(), see Config::Iconify
+	unsigned int ignoreUnmaps = 0;	//UnmapNotify wm caused itself, still to come
+	Properties properties;	//Cached, kept current from PropertyNotify
+	Handle handle;		//Own slot in the ClientStore
+	Handle wsPrev;		//Neighbours on the same workspace
+	Handle wsNext;
+};
+
+//Managed clients, kept in a slot map so handles to them stay valid while
+//other clients come and go, with a Window index for O(1) event lookups.
+//Every workspace additionally links its own members in insertion order, so
+//workspace operations only touch the clients they are about.
+class ClientStore {
+	public:
+		using Iterator = SlotMap<Client>::Iterator;
+
+		ClientStore(int workspaces);
+
+		Client &insert(const Client &client);
+		void erase(Window w);
+		void move(Client &client, int workspace);
+
+		Client *find(Window w);
+		Client *get(Handle h);
+
+		//Insertion order traversal
+		Client *first();
+		Client *last();
+		Client *next(const Client &client);
+		Client *prev(const Client &client);
+
+		//Workspace order traversal
+		Client *first(int workspace);
+		Client *last(int workspace);
+		Client *nextOnWorkspace(const Client &client);
+		Client *prevOnWorkspace(const Client &client);
+		size_t size(int workspace) const;
+
+		Iterator begin();
+		Iterator end();
+		size_t size() const;
+		bool empty() const;
+		void reserve(size_t n);
+
+	private:
+		struct Members {
+			Handle first;
+			Handle last;
+			size_t size = 0;
+		};
+
+		void link(Client &client);
+		void unlink(Client &client);
+
+		SlotMap<Client> _clients;
+		std::unordered_map<Window, Handle> _index;
+		std::vector<Members> _workspaces;
+};
+
+#endif
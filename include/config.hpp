@@ -0,0 +1,29 @@
+#pragma once
+#ifndef CONFIG_HPP
+#define CONFIG_HPP
+
+#include "log.hpp"
+
+#include <string>
+
+//Runtime options, taken from the wm command line
+struct Config {
+	//How windows on other workspaces are kept out of sight
+	enum Hiding {
+		Move = 0,	//Moved off-screen, still mapped
+		Iconify,	//Unmapped and marked hidden, so clients can stop drawing
+		Container	//Reparented into one window per workspace, mapped as a whole
+	};
+
+	int refreshRate = 60;	//Interactive move/resize updates per second
+	bool startupTimings = false;	//Print how long each startup phase took
+	Logger::Level logLevel = Logger::Error;	//Least severe level written out
+	Hiding hiding = Move;
+	std::string rulesPath;	//Window rules, reloaded whenever the file changes
+	std::string tracePath;	//Records the session for wmreplay when set
+
+	bool parse(int argc, char **argv);
+	static void usage();
+};
+
+#endif
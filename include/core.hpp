@@ -0,0 +1,140 @@
+#pragma once
+#ifndef CORE_HPP
+#define CORE_HPP
+
+#include "client_store.hpp"
+#include "backend.hpp"
+#include "atoms.hpp"
+#include "vector2.hpp"
+#include "config.hpp"
+#include "layout.hpp"
+#include "metrics.hpp"
+#include "rules.hpp"
+#include "workspaces.hpp"
+
+#include <deque>
+#include <array>
+#include <vector>
+
+//Window management state and policy: clients and their workspaces, focus,
+//layouts, stacking and the deferred commit of all of it. Every effect on
+//the display goes through a Backend, so the core runs as well against a
+//recording mock as against the server. WindowManager turns X events and
+//IPC commands into calls to it.
+class Core {
+	public:
+		using Clients = ClientStore;
+
+		enum Direction {
+			Left = 0,
+			Right,
+			Up,
+			Down
+		};
+
+		constexpr static int nWorkspaces = Workspaces::graph.size();
+		constexpr static unsigned int borderWidth = 0;
+
+		//The atoms are read on use, they may be interned later
+		Core(Backend &backend, Metrics &metrics, const NetAtom &netAtoms,
+				Config::Hiding hiding, Vector2 screen);
+
+		//Clients
+		//Takes over managed.window, placed on the current workspace unless
+		//the rules say otherwise. Layout is left to the caller, once the
+		//whole batch is in.
+		Client &manage(Client managed, const Rules::Actions &actions);
+		//Hands the window back to the root window and forgets the client
+		void unmanage(const Client &client);
+		//Maps windows that asked for it, where their clients belong. Only
+		//the workspaces of those just framed are laid out again.
+		void map(const std::vector<Window> &windows, const std::vector<Window> &framed);
+		//Leaves every client where the next wm can see it, then unmanages it
+		void release();
+		void dock(Vector2 position, Vector2 size);
+		void createContainers();
+
+		//Focus
+		void focus(Client &client);
+		void focusLast();
+		void focusNext();
+		void focusPrev();
+		//Shows client, switching to its workspace, and focuses it
+		void activate(Client &client);
+
+		//Workspaces
+		void switchWorkspace(int workspace);
+		void moveClient(Client &client, int workspace);
+		int workspaceMap(Direction dir) const;
+		int currentWorkspace() const;
+		Layout::Mode layout(int workspace) const;
+		void setLayout(int workspace, Layout::Mode mode);
+
+		//Geometry
+		void zoomClient(Client &client);
+		void relayout(int workspace);
+		void configure(Client &client, const Layout::Geometry &g);
+		//What of requested a client may have, given its layout
+		Layout::Geometry allowed(const Client &client, const Layout::Geometry &requested) const;
+		//The server reports where client is, as of request serial
+		void configured(Client &client, Vector2 position, Vector2 size, unsigned long serial);
+		void markDirty(Client &client);
+		//Mirrors a restack the server was asked for
+		void restack(Window w, int mode, Window sibling);
+
+		//Sends the final state of a batch, see core.cpp
+		void commit();
+		void commitGeometry();
+		//Whether an EnterNotify with this serial came from wm's own requests
+		bool caused(unsigned long serial);
+
+		Client *find(Window w);
+		Client *focused();
+		Clients &clients();
+
+	private:
+		constexpr static size_t maxCrossings = 64;
+
+		using Layouts = std::array<Layout::Mode, static_cast<size_t>(nWorkspaces)>;
+
+		void hide(Client &client);
+		void show(Client &client);
+		void reparent(Client &client);
+		void setState(Client &client, long state);
+		void erase(Window w);
+		void commitFocus();
+		void sendGeometry(Client &client);
+		void crossing();
+		void publishClient(Window w);
+		void publishDesktop(const Client &client);
+		Layout::Geometry workArea() const;
+		Layout::Geometry clamp(const Layout::Geometry &g) const;
+		Vector2 hiddenOffset() const;
+		void printLayout() const;
+
+		Clients _clients;
+		Layouts _layouts{};	//Every workspace starts out floating
+		std::vector<Window> _stacking;	//Managed clients, bottom to top
+		std::vector<Handle> _dirty;		//Clients with geometry to send
+		//Serials [first, second) of requests that may have moved windows
+		//under the pointer, oldest first
+		std::deque<std::pair<unsigned long, unsigned long>> _crossings;
+		std::array<Window, nWorkspaces> _containers{};	//Only with Config::Container
+		Backend &_backend;
+		Metrics &_metrics;
+		const NetAtom &_netAtoms;
+		const Config::Hiding _hiding;
+		const Vector2 _screen;
+		Handle _focused;
+		bool _clientListDirty = false;	//Needs a rewrite in commit()
+		bool _stackingDirty = false;
+		bool _focusDirty = false;		//_focused still to be given input focus
+		bool _desktopDirty = false;		//_NET_CURRENT_DESKTOP still to be set
+		bool _crossing = false;			//Since _crossingStart, see crossing()
+		unsigned long _crossingStart = 0;
+		int _currentWorkspace = 0;
+		int _lowerBorder = 0;
+		int _upperBorder = 0;
+};
+
+#endif
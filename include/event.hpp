@@ -2,6 +2,9 @@
 #ifndef EVENT_HPP
 #define EVENT_HPP
 
+#include <string_view>
+#include <array>
+
 namespace Event {
 
 constexpr static auto RequestAtom = "WM_REQUEST";
@@ -14,9 +17,95 @@ enum {
 	Exit,
 	FocusNext,
 	FocusPrev,
+	LayoutMode,
 	NEvents
 };
 
+//Queries need a reply, so they only exist over the IPC socket
+enum {
+	Focused = 0,
+	ClientList,
+	CurrentWorkspace,
+	Stats,
+	NQueries
+};
+
+struct Option {
+	const std::string_view name;
+	const int args;
+};
+
+constexpr std::array<Option, static_cast<size_t>(NEvents)> options = {{
+	{ "move", 1 },		//Move focused window to workspace
+	{ "go",   1 },		//Change active workspace
+	{ "zoom", 0 },		//Zoom focused window
+	{ "kill", 0 },		//Kill focused window
+	{ "exit", 0 },		//Exit wm
+	{ "focusnext", 0},	//Focus next window in workspace
+	{ "focusprev", 0},	//Focus previous window in workspace
+	{ "layout", 1 }		//Change layout of active workspace
+}};
+
+constexpr std::array<std::string_view, static_cast<size_t>(NQueries)> queries = {{
+	"focused",			//Focused window
+	"clients",			//Every managed window
+	"workspace",		//Active workspace
+	"stats"				//Metrics snapshot as JSON
+}};
+
+//Indexed by Core::Direction
+constexpr std::array<std::string_view, 4> directions = {{
+	"left",
+	"right",
+	"up",
+	"down"
+}};
+
+//Indexed by Layout::Mode
+constexpr std::array<std::string_view, 3> layouts = {{
+	"float",
+	"master",
+	"grid"
+}};
+
+//Index of name in table, or -1
+template<typename Table, typename Key>
+constexpr long lookup(const Table &table, std::string_view name, Key key) {
+	for(size_t i = 0; i < table.size(); i++) {
+		if(key(table[i]) == name) return static_cast<long>(i);
+	}
+	return -1l;
+}
+
+constexpr long option(std::string_view name) {
+	return lookup(options, name, [](const Option &o) { return o.name; });
+}
+
+constexpr long query(std::string_view name) {
+	return lookup(queries, name, [](std::string_view q) { return q; });
+}
+
+constexpr long direction(std::string_view name) {
+	return lookup(directions, name, [](std::string_view d) { return d; });
+}
+
+constexpr long layout(std::string_view name) {
+	return lookup(layouts, name, [](std::string_view l) { return l; });
+}
+
+//Argument of option type as it is sent to wm, -1 if it names nothing
+constexpr long argument(long type, std::string_view arg) {
+	switch(type) {
+		case MoveDirection:
+		case GoDirection:
+			return direction(arg);
+		case LayoutMode:
+			return layout(arg);
+		default:
+			return -1l;
+	}
+}
+
 }
 
 #endif
@@ -0,0 +1,86 @@
+#pragma once
+#ifndef EVENT_LOOP_HPP
+#define EVENT_LOOP_HPP
+
+#include <initializer_list>
+#include <unordered_map>
+#include <functional>
+#include <chrono>
+#include <memory>
+#include <string>
+
+//epoll readiness loop. Every event source is a file descriptor, whose
+//callback runs when it becomes readable.
+class EventLoop {
+	public:
+		using Callback = std::function<void()>;
+
+		static std::unique_ptr<EventLoop> create();
+		~EventLoop();
+
+		bool watch(int fd, Callback callback);
+		void unwatch(int fd);
+
+		//Blocks until at least one source is ready and runs its callback
+		void wait();
+
+	private:
+		EventLoop(int fd);
+
+		const int _fd;
+		std::unordered_map<int, Callback> _callbacks;
+};
+
+//One-shot timerfd
+class Timer {
+	public:
+		Timer();
+		~Timer();
+
+		int fd() const;
+		bool armed() const;
+		void arm(std::chrono::nanoseconds delay);
+		void disarm();
+
+		//Consumes the expiration, call from the readable callback
+		void acknowledge();
+
+	private:
+		const int _fd;
+		bool _armed = false;
+};
+
+//signalfd, the signals are blocked from regular delivery while it lives
+class Signals {
+	public:
+		Signals(std::initializer_list<int> signals);
+		~Signals();
+
+		int fd() const;
+
+		//Next pending signal, or 0 once drained
+		int next();
+
+	private:
+		int _fd;
+};
+
+//inotify on one file. The directory holding it is watched, so editors that
+//save by replacing the file are noticed as well.
+class FileWatch {
+	public:
+		FileWatch(const std::string &path);
+		~FileWatch();
+
+		//-1 if the directory cannot be watched
+		int fd() const;
+
+		//Consumes pending notifications, true if any concerned the file
+		bool changed();
+
+	private:
+		int _fd;
+		std::string _name;
+};
+
+#endif
@@ -0,0 +1,49 @@
+#pragma once
+#ifndef IPC_HPP
+#define IPC_HPP
+
+#include "event_loop.hpp"
+
+#include <unordered_map>
+#include <string_view>
+#include <functional>
+#include <memory>
+#include <string>
+
+//Local request/reply channel between wm and wmevent. A request is one line
+//of text, "go left" or "clients". The reply starts with "ok" or "error",
+//followed by any payload lines, and ends when the connection is closed.
+namespace Ipc {
+
+//Socket path for the display in $DISPLAY
+std::string socketPath();
+
+//Sends one request and waits for its reply, false if no wm is listening
+bool request(std::string_view line, std::string &reply);
+
+}
+
+class IpcServer {
+	public:
+		using Handler = std::function<std::string(std::string_view request)>;
+
+		//Serves requests from loop, handler answers them
+		static std::unique_ptr<IpcServer> create(const std::string &path, 
+				EventLoop &loop, Handler handler);
+		~IpcServer();
+
+	private:
+		IpcServer(int fd, const std::string &path, EventLoop &loop, Handler handler);
+		void accept();
+		void read(int fd);
+		void reply(int fd, const std::string &reply);
+		void drop(int fd);
+
+		const int _fd;
+		const std::string _path;
+		EventLoop &_loop;
+		const Handler _handler;
+		std::unordered_map<int, std::string> _connections;	//Partial requests
+};
+
+#endif
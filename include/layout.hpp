@@ -0,0 +1,33 @@
+#pragma once
+#ifndef LAYOUT_HPP
+#define LAYOUT_HPP
+
+#include "vector2.hpp"
+
+#include <cstddef>
+
+//Tiling arrangements. A tile only depends on the area, the number of tiles
+//and its own index, so any single tile can be computed on its own.
+namespace Layout {
+
+enum Mode {
+	Floating = 0,	//Clients keep whatever geometry they have
+	MasterStack,	//First client on the left, the rest stacked on the right
+	Grid,			//Rows of equal cells, the last row stretched to fill
+	NModes
+};
+
+struct Geometry {
+	Vector2 position;
+	Vector2 size;
+};
+
+//Geometry of tile index out of count, never called for Floating
+Geometry tile(Mode mode, const Geometry &area, size_t count, size_t index);
+
+//Columns of a grid holding count tiles
+size_t gridColumns(size_t count);
+
+}
+
+#endif
@@ -2,42 +2,91 @@
 #ifndef LOG_HPP
 #define LOG_HPP
 
-#include <iostream>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
 
-//Define LOG_DEBUG and LOG_ERROR before including this header
+//Asynchronous logging. A record is formatted into a fixed size buffer on
+//the calling thread and handed to a lock-free ring, a background thread
+//writes it out. Disabled levels cost one relaxed load and nothing else.
+//Operands are formatted where they are logged because strings, most of
+//them temporaries, have to be copied there anyway, and an integer costs
+//about as much to convert as to copy tagged. Time stamps and the file and
+//line prefix are left to the writer thread.
+//
+//	LogDebug << "Framed window: " << w << '\n';
 
 namespace Logger {
-	//Dummy class that the compiler ideally will remove
-	class DummyStream {
+	enum Level {
+		Debug = 0,
+		Error,
+		Off
+	};
+
+	//Records below the threshold are skipped before any formatting
+	extern std::atomic<int> threshold;
+
+	inline bool enabled(Level level) {
+		return level >= threshold.load(std::memory_order_relaxed);
+	}
+
+	void setLevel(Level level);
+
+	//"debug", "error" or "off"
+	bool parseLevel(std::string_view name, Level &level);
+
+	//What travels through the ring, text longer than this is truncated
+	struct Entry {
+		constexpr static size_t capacity = 224;
+
+		uint64_t time;		//Nanoseconds since the epoch
+		const char *file;	//Always a literal, so only the pointer is copied
+		uint32_t line;
+		uint16_t length;
+		uint8_t level;
+		char text[capacity];
+	};
+
+	//One log statement, submitted when the full expression ends
+	class Record {
 		public:
-			DummyStream() = default;
+			Record(Level level, const char *file, int line);
+			~Record();
+
+			Record &operator<<(std::string_view str);
+			Record &operator<<(const char *str);
+			Record &operator<<(char c);
+			Record &operator<<(bool b);
+			Record &operator<<(double d);
 
-			template<typename T>
-			const DummyStream &operator << (const T &rhs) const {
-				return *this;	//Just allow the operation
+			template<typename T, typename = std::enable_if_t<std::is_integral_v<T> > >
+			Record &operator<<(T value) {
+				if constexpr(std::is_signed_v<T>) {
+					return integer(static_cast<long long>(value) );
+				} else {
+					return integer(static_cast<unsigned long long>(value) );
+				}
 			}
 
 		private:
-			DummyStream(const DummyStream &rhs) = delete;
-			DummyStream(DummyStream &&rhs) = delete;
-	};
+			Record(const Record &rhs) = delete;
+			Record(Record &&rhs) = delete;
+
+			Record &integer(long long value);
+			Record &integer(unsigned long long value);
 
-	constexpr static DummyStream dummyStream;
+			Entry _entry;
+	};
 }
 
-#define CURRENT_LOCATION "File:" << __FILE__ << " Line:" << __LINE__ << ' '
-#define DEBUG_STREAM std::cout
-#define ERROR_STREAM std::cerr
+//The else branch keeps operands unevaluated while the level is disabled
+#define LOG_AT(level) \
+	if(!Logger::enabled(level) ) {} \
+	else Logger::Record(level, __FILE__, __LINE__)
 
-#if LOG_DEBUG == 1
-	#define LogDebug DEBUG_STREAM << CURRENT_LOCATION
-#else
-	#define LogDebug Logger::dummyStream
-#endif
-#if LOG_ERROR == 1
-	#define LogError ERROR_STREAM << CURRENT_LOCATION
-#else
-	#define LogError Logger::dummyStream
-#endif
+#define LogDebug LOG_AT(Logger::Debug)
+#define LogError LOG_AT(Logger::Error)
 
 #endif
@@ -0,0 +1,93 @@
+#pragma once
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+extern "C" {
+	#include <X11/Xlib.h>
+}
+
+#include "event.hpp"
+
+#include <cstdint>
+#include <chrono>
+#include <string>
+#include <array>
+
+//Log-bucketed latency histogram, bucket i counts samples below 2^i ns
+class Histogram {
+	public:
+		constexpr static size_t nBuckets = 40;	//Up to ~9 minutes
+
+		void record(uint64_t ns);
+		uint64_t count() const;
+
+		//Upper bound of the bucket holding the given quantile
+		uint64_t quantile(double q) const;
+		void json(std::string &out) const;
+
+	private:
+		std::array<uint64_t, nBuckets> _buckets = {};
+		uint64_t _count = 0;
+		uint64_t _sum = 0;
+		uint64_t _max = 0;
+};
+
+//Hot path instrumentation: handling time and blocking round-trips per X
+//event type and per IPC command, plus a few counters. Dumped as JSON.
+class Metrics {
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		//What became of a ConfigureRequest
+		enum Configure {
+			Forwarded = 0,	//Sent to the server as asked
+			Rewritten,		//Sent after policy changed it
+			Suppressed,		//Nothing to send, answered with a synthetic notify
+			Coalesced,		//Merged into an earlier request for the same window
+			NConfigure
+		};
+
+		//What became of an EnterNotify
+		enum Enter {
+			Followed = 0,	//Focus followed the pointer
+			Caused,			//wm moved, raised or mapped a window under the pointer
+			Grab,			//Crossing from a grab or ungrab, not from motion
+			Inferior,		//Pointer came back out of a subwindow
+			NEnter
+		};
+
+		//Every blocking Xlib call the wm makes reports itself here
+		void roundTrip(unsigned long n = 1);
+		unsigned long roundTrips() const;
+
+		void event(int type, Clock::duration time, unsigned long roundTrips);
+		void command(long type, Clock::duration time, unsigned long roundTrips);
+		void query(long type, Clock::duration time, unsigned long roundTrips);
+
+		void framed(unsigned long windows, unsigned long roundTrips);
+		void workspaceSwitch();
+		void configureRequest(Configure outcome);
+		void enterNotify(Enter outcome);
+
+		std::string json(size_t clients) const;
+
+	private:
+		struct Handler {
+			Histogram latency;
+			unsigned long roundTrips = 0;
+		};
+
+		static void json(std::string &out, const char *name, const Handler &handler);
+
+		std::array<Handler, LASTEvent> _events;
+		std::array<Handler, static_cast<size_t>(Event::NEvents)> _commands;
+		std::array<Handler, static_cast<size_t>(Event::NQueries)> _queries;
+		unsigned long _roundTrips = 0;
+		unsigned long _framedWindows = 0;
+		unsigned long _frameRoundTrips = 0;
+		unsigned long _workspaceSwitches = 0;
+		std::array<unsigned long, NConfigure> _configureRequests = {};
+		std::array<unsigned long, NEnter> _enterNotifies = {};
+};
+
+#endif
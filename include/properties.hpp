@@ -0,0 +1,67 @@
+#pragma once
+#ifndef PROPERTIES_HPP
+#define PROPERTIES_HPP
+
+extern "C" {
+	#include <X11/Xlib.h>
+}
+
+#include "vector2.hpp"
+#include "atoms.hpp"
+
+#include <string>
+#include <vector>
+
+//A property as the server returned it, format 8 in bytes, 32 in values
+struct PropertyValue {
+	Atom type = None;	//None if the property does not exist
+	int format = 0;
+	std::string bytes;
+	std::vector<long> values;
+};
+
+//Client properties the wm bases decisions on. Read in one batch when a
+//window is framed. PropertyNotify only marks a kind stale, it is read
+//again the next time the wm needs it, so a client retitling itself on
+//every keystroke costs no round-trip at all.
+struct Properties {
+	enum Kind {
+		WindowType = 0,
+		Class,
+		NetName,
+		Name,
+		Protocols,
+		NormalHints,
+		NetState,
+		NKinds
+	};
+
+	//What to ask the server for to read a kind
+	struct Request {
+		Atom property;
+		Atom type;
+		long length;	//In 32 bit units
+	};
+
+	Atom windowType = None;		//First _NET_WM_WINDOW_TYPE atom, if any
+	std::string resName;
+	std::string resClass;
+	std::string title;			//_NET_WM_NAME, WM_NAME if there is none
+	bool netName = false;		//title came from _NET_WM_NAME
+	bool deleteWindow = false;	//WM_DELETE_WINDOW listed in WM_PROTOCOLS
+	Vector2 minSize;			//WM_NORMAL_HINTS, zero where unset
+	Vector2 maxSize;
+	std::vector<Atom> netState;	//_NET_WM_STATE, owned by wm once framed
+	unsigned stale = 0;			//Bit per Kind changed since it was read
+
+	//Updates kind from value, an absent property resets it
+	void set(Kind kind, const PropertyValue &value, const IccAtom &iccAtoms);
+
+	static Request request(Kind kind, const NetAtom &netAtoms, const IccAtom &iccAtoms);
+
+	//Kind cached for property, false if it is not one of ours
+	static bool kind(Atom property, const NetAtom &netAtoms, const IccAtom &iccAtoms,
+			Kind &kind);
+};
+
+#endif
@@ -0,0 +1,84 @@
+#pragma once
+#ifndef RULES_HPP
+#define RULES_HPP
+
+#include <functional>
+#include <string_view>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <array>
+
+//Window rules, one per line. Matchers compare a window property exactly,
+//actions say what to do with a window matching all of them:
+//
+//	#Matchers: class, instance, title, type	Actions: workspace, zoom, float
+//	class=firefox workspace=north
+//	class=mpv type=normal float
+//	title="Picture-in-Picture" zoom
+//
+//Rules are compiled into one hash table per combination of matchers in use,
+//so matching costs one lookup per combination, whatever the number of rules,
+//and never allocates.
+class Rules {
+	public:
+		enum Field {
+			Class = 0,
+			Instance,
+			Title,
+			Type,
+			NFields
+		};
+
+		struct Actions {
+			int workspace = -1;		//-1 leaves the window where it is
+			bool zoom = false;
+			bool floating = false;	//Kept out of tiling layouts
+
+			void merge(const Actions &rhs);
+		};
+
+		//Properties of the window to match, indexed by Field
+		using Subject = std::array<std::string_view, NFields>;
+
+		//Workspace index for a name, -1 if there is none
+		using WorkspaceLookup = std::function<int(std::string_view)>;
+
+		//Replaces the rules with the ones in text. On failure the rules are
+		//left as they were, error names the offending line.
+		bool compile(std::string_view text, const WorkspaceLookup &workspace,
+				std::string &error);
+
+		//Actions of every matching rule, merged in file order
+		Actions match(const Subject &subject) const;
+
+		size_t size() const;
+
+	private:
+		struct Entry {
+			uint64_t hash;
+			unsigned fields;	//Bit per Field that is matched on
+			std::array<uint32_t, NFields> offset;	//Into _strings
+			std::array<uint32_t, NFields> length;
+			uint32_t order;		//Line of the rule
+			uint32_t next;		//Entry index + 1 of the next line with the same key, 0 ends
+			Actions actions;
+		};
+
+		//Open addressing table over the entries matching the same fields
+		struct Shape {
+			unsigned fields;
+			std::vector<uint32_t> slots;	//Entry index + 1 of the first line with a key, 0 is empty
+		};
+
+		static uint64_t hash(const Subject &subject, unsigned fields);
+		Subject subject(const Entry &entry) const;
+		bool equal(const Entry &entry, const Subject &subject) const;
+		const Entry *find(const Shape &shape, const Subject &subject) const;
+
+		std::string _strings;
+		std::vector<Entry> _entries;
+		std::vector<Shape> _shapes;
+};
+
+#endif
@@ -0,0 +1,187 @@
+#pragma once
+#ifndef SLOT_MAP_HPP
+#define SLOT_MAP_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+//Stable reference into a SlotMap. Survives insertion and removal of other
+//elements, goes stale once its own element is erased
+struct Handle {
+	constexpr static uint32_t invalidIndex = UINT32_MAX;
+
+	uint32_t index = invalidIndex;
+	uint32_t generation = 0;
+
+	bool valid() const {
+		return index != invalidIndex;
+	}
+
+	bool operator==(const Handle rhs) const {
+		return index == rhs.index && generation == rhs.generation;
+	}
+
+	bool operator!=(const Handle rhs) const {
+		return !(*this == rhs);
+	}
+};
+
+//Generational slot map. Freed slots are recycled with a bumped generation,
+//so stale handles are detected instead of aliasing a newer element. Live
+//elements are additionally linked in insertion order.
+template<typename T>
+class SlotMap {
+	struct Slot;
+
+	public:
+		class Iterator {
+			public:
+				Iterator(std::vector<Slot> *slots, uint32_t index)
+					: _slots(slots), _index(index) {}
+
+				T &operator*() const {
+					return (*_slots)[_index].value;
+				}
+
+				T *operator->() const {
+					return &(*_slots)[_index].value;
+				}
+
+				Iterator &operator++() {
+					_index = (*_slots)[_index].next;
+					return *this;
+				}
+
+				bool operator!=(const Iterator &rhs) const {
+					return _index != rhs._index;
+				}
+
+			private:
+				std::vector<Slot> *_slots;
+				uint32_t _index;
+		};
+
+		Handle insert(const T &value) {
+			uint32_t index = _free;
+			if(index == Handle::invalidIndex) {
+				index = static_cast<uint32_t>(_slots.size() );
+				_slots.emplace_back();
+			} else {
+				_free = _slots[index].next;
+			}
+
+			Slot &slot = _slots[index];
+			slot.value = value;
+			slot.alive = true;
+			slot.prev = _last;
+			slot.next = Handle::invalidIndex;
+
+			if(_last != Handle::invalidIndex) {
+				_slots[_last].next = index;
+			} else {
+				_first = index;
+			}
+			_last = index;
+			_size++;
+
+			return {index, slot.generation};
+		}
+
+		void erase(Handle h) {
+			if(!contains(h) ) return;
+
+			Slot &slot = _slots[h.index];
+
+			if(slot.prev != Handle::invalidIndex) {
+				_slots[slot.prev].next = slot.next;
+			} else {
+				_first = slot.next;
+			}
+
+			if(slot.next != Handle::invalidIndex) {
+				_slots[slot.next].prev = slot.prev;
+			} else {
+				_last = slot.prev;
+			}
+
+			slot.alive = false;
+			slot.generation++;
+			slot.next = _free;
+			_free = h.index;
+			_size--;
+		}
+
+		bool contains(Handle h) const {
+			return h.index < _slots.size()
+				&& _slots[h.index].alive
+				&& _slots[h.index].generation == h.generation;
+		}
+
+		T *get(Handle h) {
+			return contains(h) ? &_slots[h.index].value : nullptr;
+		}
+
+		const T *get(Handle h) const {
+			return contains(h) ? &_slots[h.index].value : nullptr;
+		}
+
+		//Insertion order traversal
+		Handle first() const {
+			return handle(_first);
+		}
+
+		Handle last() const {
+			return handle(_last);
+		}
+
+		Handle next(Handle h) const {
+			return contains(h) ? handle(_slots[h.index].next) : Handle{};
+		}
+
+		Handle prev(Handle h) const {
+			return contains(h) ? handle(_slots[h.index].prev) : Handle{};
+		}
+
+		Iterator begin() {
+			return {&_slots, _first};
+		}
+
+		Iterator end() {
+			return {&_slots, Handle::invalidIndex};
+		}
+
+		size_t size() const {
+			return _size;
+		}
+
+		bool empty() const {
+			return _size == 0;
+		}
+
+		void reserve(size_t n) {
+			_slots.reserve(n);
+		}
+
+	private:
+		struct Slot {
+			T value;
+			uint32_t generation = 0;
+			bool alive = false;
+			uint32_t prev = Handle::invalidIndex;	//Unused while free
+			uint32_t next = Handle::invalidIndex;	//Free list link while free
+		};
+
+		Handle handle(uint32_t index) const {
+			if(index == Handle::invalidIndex) return {};
+			return {index, _slots[index].generation};
+		}
+
+		std::vector<Slot> _slots;
+		uint32_t _free = Handle::invalidIndex;
+		uint32_t _first = Handle::invalidIndex;
+		uint32_t _last = Handle::invalidIndex;
+		size_t _size = 0;
+};
+
+#endif
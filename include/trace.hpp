@@ -0,0 +1,118 @@
+#pragma once
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+extern "C" {
+	#include <X11/Xlib.h>
+	#include <X11/Xproto.h>
+}
+
+#include "vector2.hpp"
+
+#include <string_view>
+#include <cstdint>
+#include <cstdio>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+//Recording of everything that drove a wm session, for wmreplay to play back
+//through the same handlers. Taken with "wm -T FILE".
+//
+//The file is "WMTRACE1", the recorded root window as a uint64_t, then
+//records of a Header followed by length bytes of payload:
+//	Received	XEvent up to its last nonzero byte, display pointer cleared
+//	Command		IPC request text
+//	AtomName	uint64_t atom, then its name
+//	Frame		nothing, the drag timer fired
+//	Pointer		two int32_t, where XQueryPointer found the pointer
+//	Commit		uint64_t serial of the next request, a batch ended
+//Events are recorded as Xlib reads them off the connection, so the ones a
+//handler takes out of the queue itself are in there too.
+namespace Trace {
+
+enum Kind : uint8_t {
+	Received = 0,
+	Command,
+	AtomName,
+	Frame,
+	Pointer,
+	Commit,
+	NKinds
+};
+
+struct Header {
+	uint64_t time;		//ns since the trace started
+	uint32_t length;	//Of the payload
+	uint8_t kind;
+	uint8_t pad[3];
+};
+
+constexpr char magic[8] = {'W', 'M', 'T', 'R', 'A', 'C', 'E', '1'};
+
+struct Record {
+	Kind kind;
+	uint64_t time;
+	std::string data;
+};
+
+struct File {
+	Window root = None;
+	std::vector<Record> records;
+};
+
+//False with error set if path is not a whole trace
+bool load(const std::string &path, File &file, std::string &error);
+
+//What a replay cost the wm
+struct Totals {
+	size_t events = 0;
+	size_t commands = 0;
+	size_t frames = 0;
+	size_t batches = 0;
+	std::chrono::nanoseconds handler{0};	//In handlers and commits only
+	std::chrono::nanoseconds wall{0};
+	unsigned long requests = 0;
+	unsigned long roundTrips = 0;
+	std::string stats;	//The stats query reply
+};
+
+//Appends to a trace file. Only one can be attached to a display at a time,
+//events are picked up by replacing Xlib's wire-to-event converters.
+class Writer {
+	public:
+		static std::unique_ptr<Writer> create(const std::string &path, Display *display);
+		~Writer();
+
+		void command(std::string_view request);
+		void frame();
+		void pointer(Vector2 position);
+
+		//Ends a batch and writes it out, empty batches are left out
+		void commit();
+
+	private:
+		using Clock = std::chrono::steady_clock;
+		using WireToEvent = Bool (*)(Display*, XEvent*, xEvent*);
+
+		Writer(std::FILE *file, Display *display);
+		static Bool onWire(Display *display, XEvent *event, xEvent *wire);
+		void record(Kind kind, const void *data, size_t length);
+		void received(const XEvent &e);
+		void name(Atom atom);
+
+		static Writer *_active;
+		static WireToEvent _converters[LASTEvent];
+
+		std::string _batch;	//Records since the last commit
+		std::vector<Atom> _named;	//Sorted
+		std::vector<Atom> _unnamed;	//Seen in this batch, named at commit
+		std::FILE *_file;
+		Display *_display;
+		const Clock::time_point _start;
+};
+
+}
+
+#endif
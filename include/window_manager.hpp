@@ -6,112 +6,139 @@ extern "C" {
 	#include <X11/Xlib.h>
 }
 
+#include "client_store.hpp"
+#include "window_query.hpp"
+#include "x_backend.hpp"
+#include "core.hpp"
 #include "vector2.hpp"
 #include "atoms.hpp"
+#include "config.hpp"
+#include "event_loop.hpp"
+#include "metrics.hpp"
+#include "event.hpp"
+#include "ipc.hpp"
+#include "layout.hpp"
+#include "rules.hpp"
+#include "workspaces.hpp"
+#include "trace.hpp"
 
-#include <unordered_map>
 #include <functional>
+#include <chrono>
 #include <memory>
-#include <vector>
+#include <array>
 
-struct Client {
-	Window window;		//Handle to window
-	int workspace;		//Workspace index
-	Vector2 restore;	//"Old" coordinates
-	Vector2 size;		//Dimension
-	Vector2 position;	//Positon
-	bool fullscreen = false;
-};
+#include <csignal>
+#include <string>
+#include <vector>
 
 class WindowManager {
 	public:
-		using Clients = std::vector<Client>;
-		using ClassMap = std::unordered_map<std::string, int>;
+		using Events = std::array<std::function<void(long*)>, 
+			static_cast<size_t>(Event::NEvents)>;
 
-		static std::unique_ptr<WindowManager> create();
+		static std::unique_ptr<WindowManager> create(const Config &config);
 		~WindowManager();
 		void run();
 
-		//Enums
-		enum Direction {
-			Left = 0,
-			Right,
-			Up,
-			Down
+		//Runs a trace taken with -T through the handlers in place of the
+		//connection, see src/replay.cpp. False if the wm did not start.
+		bool replay(const Trace::File &trace, bool realtime, Trace::Totals &totals);
+
+	private:
+		using Clock = std::chrono::steady_clock;
+
+		//Interactive move/resize, paced to the display refresh rate
+		struct Drag {
+			Handle client;
+			unsigned int button = 0;	//Zero while no drag is active
+			bool pending = false;		//Pointer moved since the last applied frame
+			Vector2 startCursorPos, startWindowPos, startWindowSize;
+			Clock::time_point lastFrame;
 		};
 
-		enum Ws {
-			Center = 0, 
-			West, 
-			East, 
-			North, 
-			South,
-			N
+		//Time spent in each startup phase
+		struct Startup {
+			Clock::time_point mark;
+			std::vector<std::pair<const char*, Clock::duration>> phases;
+
+			void lap(const char *phase);
+			void print() const;
 		};
-	private:
 
 		//Constants
-		constexpr static int nWorkspaces = static_cast<int>(Ws::N);
 		constexpr static auto modifierMask = Mod1Mask;
-		constexpr static unsigned int borderWidth = 0;
 
 		//Init
-		WindowManager(Display *display);
+		WindowManager(Display *display, const Config &config);
 		static int onXError(Display *display, XErrorEvent *e);
 		static int onWmDetected(Display *display, XErrorEvent *e);
+		bool start();
+		void stop();
 
 		//Event handlers
 		void onConfigureRequest(const XConfigureRequestEvent &e);
+		void onConfigureNotify(const XConfigureEvent &e);
 		void onMapRequest(const XMapRequestEvent &e);
 		void onUnmapNotify(const XUnmapEvent &e);
+		void onDestroyNotify(const XDestroyWindowEvent &e);
 		void onButtonPress(const XButtonEvent &e);
+		void onButtonRelease(const XButtonEvent &e);
 		void onFocusIn(const XFocusChangeEvent &e);
 		void onEnterNotify(const XEnterWindowEvent &e);
+		void onPropertyNotify(const XPropertyEvent &e);
 		void onMotionNotify(const XMotionEvent &e);
+		void onDragTimer();
+		void onSignal();
+		std::string onIpcRequest(std::string_view request);
 
 		//Basic functions
-		void focus(Client &client);
-		void focusLast();
-		void focusNext();
-		void focusPrev();
-		bool frame(Window w, bool createdBefore);
-		void unframe(const Client &client);
-		void switchWorkspace(int workspace);
-		void hide(Client &client);
-		void show(const Client &client);
-		void kill(const Client &client);
-		void moveClient(Client &client, int workspace);
-		void zoomClient(Client &client);
-		Atom *getWindowProperty(Window w) const;
-		void registerDock(Window w);
-		constexpr int workspaceMap(Direction dir) const;
+		bool frame(const WindowInfo &info, bool createdBefore);
+		void adopt();
+		void kill(Client &client);
+		Properties &properties(Client &client);
+		void readProperty(Client &client, Properties::Kind kind);
+		void loadRules();
+		std::string_view typeName(Atom type) const;
 
 		//Helper functions
-		void printLayout() const;
-		void erase(Window w);
-		Clients::iterator find(Window w);
+		void processEvents();
+		void handleEvent(XEvent &e);
+		void coalesceConfigure(XConfigureRequestEvent &e);
+		void applyDrag(Vector2 cursorPos);
 
 		//Containers
-		Clients _clients;
-		ClassMap _classMap;
+		Rules _rules;
+		FileWatch _rulesWatch;
+		Events _events;
+		std::unique_ptr<EventLoop> _loop;
+		std::unique_ptr<IpcServer> _ipc;
+		std::unique_ptr<Trace::Writer> _trace;	//Only with Config::tracePath
+		Timer _dragTimer;
+		Signals _signals{SIGTERM, SIGINT, SIGHUP, SIGUSR1};
+		Metrics _metrics;
 
 		//Near-primitives
-		Vector2 startCursorPos, startWindowPos, startWindowSize;
+		Drag _drag;
+		Startup _startup;
+		const Clock::duration _frameInterval;
+		const bool _startupTimings;
+		const std::string _rulesPath;
+		const std::string _tracePath;
 		Display *_display;
 		const Window _root;
 		const Window _check;	//Dummy window to allow _NET_SUPPORTING_WM_CHECK
-		Client *_focused;
 		Screen *_screen;
 		static bool _wmDetected;
 		bool _running = true;
-		int _currentWorkspace = 0;
-		int _lowerBorder = 0;
-		int _upperBorder = 0;
 
 		//Atoms
 		NetAtom _netAtoms;
 		IccAtom _iccAtoms;
 		OtherAtom _otherAtoms;
+
+		//State, after everything it is built from
+		XBackend _backend;
+		Core _core;
 };
 
 #endif
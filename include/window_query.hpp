@@ -0,0 +1,75 @@
+#pragma once
+#ifndef WINDOW_QUERY_HPP
+#define WINDOW_QUERY_HPP
+
+extern "C" {
+	#include <X11/Xlib.h>
+	#include <X11/Xproto.h>
+}
+
+#include "properties.hpp"
+#include "vector2.hpp"
+#include "atoms.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//Everything frame() needs to know about a window before managing it
+struct WindowInfo {
+	Window window;
+	bool hasAttributes = false;	//GetWindowAttributes reply arrived
+	bool hasGeometry = false;	//GetGeometry reply arrived
+	bool overrideRedirect = false;
+	int mapState = IsUnmapped;
+	Vector2 position;
+	Vector2 size;
+	Properties properties;
+
+	bool valid() const;
+};
+
+//Pipelined window queries, in the spirit of XCB cookies. Every request
+//for every added window is written before any reply is awaited, and all
+//replies are collected through one single round-trip.
+class WindowQuery {
+	public:
+		using Infos = std::vector<WindowInfo>;
+
+		WindowQuery(Display *display, const NetAtom &netAtoms, const IccAtom &iccAtoms);
+
+		void add(Window w);
+		void collect();
+
+		const Infos &infos() const;
+		unsigned int roundTrips() const;
+
+	private:
+		enum Kind {
+			Attributes = 0,
+			Geometry,
+			Property
+		};
+
+		struct Pending {
+			uint64_t sequence;
+			size_t info;
+			Kind kind;
+			Properties::Kind property;	//Only for Property
+		};
+
+		static Bool onReply(Display *display, xReply *rep, char *buf, int len,
+				XPointer data);
+		void send(size_t info);
+		void read(const Pending &pending, xReply *rep, char *buf, int len);
+
+		Display *_display;
+		const NetAtom &_netAtoms;
+		const IccAtom &_iccAtoms;
+		Infos _infos;
+		std::vector<Pending> _pending;
+		size_t _cursor = 0;
+		unsigned int _roundTrips = 0;
+};
+
+#endif
@@ -0,0 +1,116 @@
+#pragma once
+#ifndef WORKSPACES_HPP
+#define WORKSPACES_HPP
+
+#include <string_view>
+#include <cstddef>
+#include <array>
+
+//Workspace topology: how many workspaces there are, their names and where
+//every direction leads from each of them. The graph is fixed at compile
+//time and stored as a flat table, so "go" and "move" are one lookup.
+//
+//Build with "make GRID=3x3" for a grid, or spell out a Graph by hand below
+//for any other adjacency. Changing GRID rebuilds every object by itself.
+namespace Workspaces {
+
+constexpr size_t nDirections = 4;	//In Core::Direction order
+constexpr size_t maxNameLength = 15;
+
+//Fixed size so grid names can be generated at compile time
+struct Name {
+	char text[maxNameLength + 1] = {};
+	size_t length = 0;
+
+	constexpr Name() = default;
+	constexpr Name(std::string_view name) {
+		for(; length < name.size() && length < maxNameLength; length++) {
+			text[length] = name[length];
+		}
+	}
+
+	constexpr std::string_view view() const {
+		return {text, length};
+	}
+};
+
+template<size_t N>
+struct Graph {
+	using Row = std::array<int, nDirections>;	//Left, right, up, down
+
+	std::array<Name, N> names;
+	std::array<Row, N> next;
+
+	constexpr static int size() {
+		return static_cast<int>(N);
+	}
+
+	//Every edge lands on a workspace, every name is set and unique
+	constexpr bool valid() const {
+		for(size_t i = 0; i < N; i++) {
+			if(names[i].length == 0) return false;
+			for(size_t j = 0; j < i; j++) {
+				if(names[i].view() == names[j].view() ) return false;
+			}
+			for(int target : next[i]) {
+				if(target < 0 || target >= size() ) return false;
+			}
+		}
+		return true;
+	}
+};
+
+//Center with a workspace in each direction, wrapping around the edges
+constexpr Graph<5> compass() {
+	enum { Center = 0, West, East, North, South };
+	return {{{
+		Name("center"), Name("west"), Name("east"), Name("north"), Name("south")
+	}}, {{
+		//Left		Right		Up			Down
+		{{ West,	East,		North,		South	}},	//Center
+		{{ East,	Center,		North,		South	}},	//West
+		{{ Center,	West,		North,		South	}},	//East
+		{{ West,	East,		South,		Center	}},	//North
+		{{ West,	East,		Center,		North	}}	//South
+	}}};
+}
+
+//Columns x rows, numbered from 1 row by row, wrapping around the edges
+template<size_t Columns, size_t Rows>
+constexpr Graph<Columns * Rows> grid() {
+	static_assert(Columns > 0 && Rows > 0, "A grid needs at least one workspace");
+	Graph<Columns * Rows> graph = {};
+	constexpr int c = static_cast<int>(Columns), r = static_cast<int>(Rows);
+
+	for(int i = 0; i < c * r; i++) {
+		const int x = i % c, y = i / c;
+		graph.next[i] = {{
+			y * c + (x + c - 1) % c,
+			y * c + (x + 1) % c,
+			(y + r - 1) % r * c + x,
+			(y + 1) % r * c + x
+		}};
+
+		Name &name = graph.names[i];
+		char digits[maxNameLength] = {};
+		size_t n = 0;
+		for(int number = i + 1; number > 0 && n < maxNameLength; number /= 10) {
+			digits[n++] = static_cast<char>('0' + number % 10);
+		}
+		while(n > 0) name.text[name.length++] = digits[--n];
+	}
+
+	return graph;
+}
+
+#if defined(WM_GRID_COLUMNS) && defined(WM_GRID_ROWS)
+constexpr auto graph = grid<WM_GRID_COLUMNS, WM_GRID_ROWS>();
+#else
+constexpr auto graph = compass();
+#endif
+
+static_assert(graph.valid(), "Workspace graph has a bad edge or name");
+
+}
+
+#endif
@@ -0,0 +1,44 @@
+#pragma once
+#ifndef X_BACKEND_HPP
+#define X_BACKEND_HPP
+
+extern "C" {
+	#include <X11/Xlib.h>
+}
+
+#include "backend.hpp"
+#include "atoms.hpp"
+
+//Backend on a live X connection, one Xlib request per call
+class XBackend : public Backend {
+	public:
+		//The atoms are read on every call, they may be interned later
+		XBackend(Display *display, const NetAtom &netAtoms, const IccAtom &iccAtoms);
+
+		void configure(Window w, unsigned int mask, Vector2 position, Vector2 size) override;
+		void notify(Window w, Vector2 position, Vector2 size) override;
+		void map(Window w) override;
+		void unmap(Window w) override;
+		void raise(Window w) override;
+		void focus(Window w) override;
+		void reparent(Window w, Window parent, Vector2 position) override;
+		void saveSet(Window w, bool add) override;
+		void setState(Window w, long state, const std::vector<Atom> &netState) override;
+		void setDesktop(Window w, int workspace) override;
+		void setCurrentDesktop(int workspace) override;
+		void setActiveWindow(Window w) override;
+		void setList(List list, const Window *windows, size_t n, bool append) override;
+		Window createContainer() override;
+
+		unsigned long nextRequest() override;
+		void noOp() override;
+		void flush() override;
+
+	private:
+		Display *_display;
+		const Window _root;
+		const NetAtom &_netAtoms;
+		const IccAtom &_iccAtoms;
+};
+
+#endif
@@ -1,30 +1,44 @@
 #include "atoms.hpp"
+#include "event.hpp"
 
-NetAtom::NetAtom(Display *display) :
-supported       (XInternAtom(display, "_NET_SUPPORTED", False)),
-activeWindow    (XInternAtom(display, "_NET_ACTIVE_WINDOW", False)),
-numberOfDesktops(XInternAtom(display, "_NET_NUMBER_OF_DESKTOPS", False)),
-currentDesktop  (XInternAtom(display, "_NET_CURRENT_DESKTOP", False)),
-WMCheck         (XInternAtom(display, "_NET_SUPPORTING_WM_CHECK", False)),
-WMName          (XInternAtom(display, "_NET_WM_NAME", False)),
-WMWindowType    (XInternAtom(display, "_NET_WM_WINDOW_TYPE", False)),
-WMWindowDock    (XInternAtom(display, "_NET_WM_WINDOW_TYPE_DOCK", False)),
-WMWindowToolbar (XInternAtom(display, "_NET_WM_WINDOW_TYPE_TOOLBAR", False)),
-WMWindowUtility (XInternAtom(display, "_NET_WM_WINDOW_TYPE_UTILITY", False)),
-WMWindowDialog  (XInternAtom(display, "_NET_WM_WINDOW_TYPE_DIALOG", False)),
-WMWindowMenu    (XInternAtom(display, "_NET_WM_WINDOW_TYPE_MENU", False)) {
+#include <algorithm>
+#include <iterator>
+#include <string_view>
+#include <vector>
+
+template<typename T>
+constexpr size_t count() {
+	static_assert(sizeof(T) == std::size(T::names) * sizeof(Atom), 
+			"Every atom needs exactly one name");
+	return std::size(T::names);
 }
 
+static_assert(std::string_view(OtherAtom::names[1]) == Event::RequestAtom);
+
 size_t NetAtom::size() const {
 	return sizeof(NetAtom) / sizeof(Atom);
 }
 
+void internAtoms(Display *display, NetAtom &net, IccAtom &icc, OtherAtom &other) {
+	std::vector<char*> names;
+	auto add = [&](const auto &table) {
+		for(const char *name : table) {
+			names.push_back(const_cast<char*>(name) );
+		}
+	};
 
-IccAtom::IccAtom(Display *display) :
-DeleteWindow   (XInternAtom(display, "WM_DELETE_WINDOW", False)),
-WMProtocols    (XInternAtom(display, "WM_PROTOCOLS", False)) {
-}
+	add(NetAtom::names);
+	add(IccAtom::names);
+	add(OtherAtom::names);
+
+	std::vector<Atom> atoms(names.size() );
+	XInternAtoms(display, names.data(), static_cast<int>(names.size() ), False, atoms.data() );
 
-OtherAtom::OtherAtom(Display *display) :
-utf8str        (XInternAtom(display, "UTF8_STRING", False)) {
+	//The structs are laid out as plain Atom arrays, see _NET_SUPPORTED
+	auto it = atoms.begin();
+	std::copy_n(it, count<NetAtom>(), reinterpret_cast<Atom*>(&net) );
+	it += count<NetAtom>();
+	std::copy_n(it, count<IccAtom>(), reinterpret_cast<Atom*>(&icc) );
+	it += count<IccAtom>();
+	std::copy_n(it, count<OtherAtom>(), reinterpret_cast<Atom*>(&other) );
 }
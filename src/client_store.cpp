@@ -0,0 +1,133 @@
+#include "client_store.hpp"
+
+#include <cassert>
+
+ClientStore::ClientStore(int workspaces) 
+	: _workspaces(static_cast<size_t>(workspaces) ) {
+}
+
+Client &ClientStore::insert(const Client &client) {
+	assert(!find(client.window) );	//A second slot would leave the first stale
+	const Handle h = _clients.insert(client);
+	Client *inserted = _clients.get(h);
+	inserted->handle = h;
+	_index[client.window] = h;
+	link(*inserted);
+	return *inserted;
+}
+
+void ClientStore::erase(Window w) {
+	auto it = _index.find(w);
+	if(it == _index.end() ) return;
+
+	unlink(*_clients.get(it->second) );
+	_clients.erase(it->second);
+	_index.erase(it);
+}
+
+void ClientStore::move(Client &client, int workspace) {
+	unlink(client);
+	client.workspace = workspace;
+	link(client);
+}
+
+Client *ClientStore::find(Window w) {
+	auto it = _index.find(w);
+	return it == _index.end() ? nullptr : _clients.get(it->second);
+}
+
+Client *ClientStore::get(Handle h) {
+	return _clients.get(h);
+}
+
+Client *ClientStore::first() {
+	return _clients.get(_clients.first() );
+}
+
+Client *ClientStore::last() {
+	return _clients.get(_clients.last() );
+}
+
+Client *ClientStore::next(const Client &client) {
+	return _clients.get(_clients.next(client.handle) );
+}
+
+Client *ClientStore::prev(const Client &client) {
+	return _clients.get(_clients.prev(client.handle) );
+}
+
+Client *ClientStore::first(int workspace) {
+	return _clients.get(_workspaces[workspace].first);
+}
+
+Client *ClientStore::last(int workspace) {
+	return _clients.get(_workspaces[workspace].last);
+}
+
+Client *ClientStore::nextOnWorkspace(const Client &client) {
+	return _clients.get(client.wsNext);
+}
+
+Client *ClientStore::prevOnWorkspace(const Client &client) {
+	return _clients.get(client.wsPrev);
+}
+
+size_t ClientStore::size(int workspace) const {
+	return _workspaces[workspace].size;
+}
+
+ClientStore::Iterator ClientStore::begin() {
+	return _clients.begin();
+}
+
+ClientStore::Iterator ClientStore::end() {
+	return _clients.end();
+}
+
+size_t ClientStore::size() const {
+	return _clients.size();
+}
+
+bool ClientStore::empty() const {
+	return _clients.empty();
+}
+
+void ClientStore::reserve(size_t n) {
+	_clients.reserve(n);
+	_index.reserve(n);
+}
+
+void ClientStore::link(Client &client) {
+	Members &members = _workspaces[client.workspace];
+
+	client.wsPrev = members.last;
+	client.wsNext = {};
+
+	if(Client *last = _clients.get(members.last) ) {
+		last->wsNext = client.handle;
+	} else {
+		members.first = client.handle;
+	}
+
+	members.last = client.handle;
+	members.size++;
+}
+
+void ClientStore::unlink(Client &client) {
+	Members &members = _workspaces[client.workspace];
+
+	if(Client *prev = _clients.get(client.wsPrev) ) {
+		prev->wsNext = client.wsNext;
+	} else {
+		members.first = client.wsNext;
+	}
+
+	if(Client *next = _clients.get(client.wsNext) ) {
+		next->wsPrev = client.wsPrev;
+	} else {
+		members.last = client.wsPrev;
+	}
+
+	client.wsPrev = client.wsNext = {};
+	members.size--;
+}
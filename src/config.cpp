@@ -0,0 +1,58 @@
+#include "config.hpp"
+
+#include <string_view>
+#include <iostream>
+#include <cstdlib>
+
+bool Config::parse(int argc, char **argv) {
+	for(int i = 1; i < argc; i++) {
+		std::string_view arg = argv[i];
+
+		if(arg == "-r" && i + 1 < argc) {
+			refreshRate = std::atoi(argv[++i]);
+			if(refreshRate <= 0) return false;
+		} else if(arg == "-l" && i + 1 < argc) {
+			if(!Logger::parseLevel(argv[++i], logLevel) ) return false;
+		} else if(arg == "-H" && i + 1 < argc) {
+			const std::string_view mode = argv[++i];
+			if(mode == "move") {
+				hiding = Move;
+			} else if(mode == "iconify") {
+				hiding = Iconify;
+			} else if(mode == "container") {
+				hiding = Container;
+			} else {
+				return false;
+			}
+		} else if(arg == "-R" && i + 1 < argc) {
+			rulesPath = argv[++i];
+		} else if(arg == "-T" && i + 1 < argc) {
+			tracePath = argv[++i];
+		} else if(arg == "-t") {
+			startupTimings = true;
+		} else {
+			return false;
+		}
+	}
+
+	if(rulesPath.empty() ) {
+		if(const char *config = std::getenv("XDG_CONFIG_HOME"); config && *config) {
+			rulesPath = std::string(config) + "/wm/rules";
+		} else if(const char *home = std::getenv("HOME") ) {
+			rulesPath = std::string(home) + "/.config/wm/rules";
+		}
+	}
+
+	return true;
+}
+
+void Config::usage() {
+	std::cout <<
+		"Usage: wm [options]\n"
+		"-r HZ         Refresh rate interactive move/resize is paced to\n"
+		"-l LEVEL      Log level, one of debug, error or off (default error)\n"
+		"-H MODE       Hide other workspaces by move (default), iconify or container\n"
+		"-R FILE       Window rules (default $XDG_CONFIG_HOME/wm/rules)\n"
+		"-T FILE       Record every event and command to FILE, for wmreplay\n"
+		"-t            Print how long each startup phase took\n";
+}
@@ -0,0 +1,584 @@
+#include "core.hpp"
+#include "log.hpp"
+
+#include <X11/Xutil.h>
+
+#include <algorithm>
+#include <string>
+
+Core::Core(Backend &backend, Metrics &metrics, const NetAtom &netAtoms,
+		Config::Hiding hiding, Vector2 screen)
+	: _clients(nWorkspaces), _backend(backend), _metrics(metrics), _netAtoms(netAtoms),
+	_hiding(hiding), _screen(screen) {
+}
+
+Client &Core::manage(Client managed, const Rules::Actions &actions) {
+	const Window w = managed.window;
+	if(auto existing = find(w) ) return *existing;	//Managed once only
+
+	if(managed.position.y < _upperBorder) {
+		managed.position.y = _upperBorder;
+	}
+
+	if(const int dy = managed.size.y + _lowerBorder + managed.position.y - _screen.y;
+			dy > 0) {
+		managed.size.y -= dy;
+	}
+
+	managed.workspace = _currentWorkspace;
+	managed.restore = managed.position;
+	managed.restoreSize = managed.size;
+	Client &client = _clients.insert(managed);
+	markDirty(client);
+	setState(client, NormalState);
+	publishClient(w);
+	if(_hiding == Config::Container) {
+		//Handed back to the root window should wm go away
+		_backend.saveSet(w, true);
+		reparent(client);
+	}
+
+	client.floating = actions.floating;
+	if(actions.zoom) {
+		zoomClient(client);
+	}
+	if(actions.workspace >= 0 && actions.workspace != client.workspace) {
+		_clients.move(client, actions.workspace);
+		hide(client);
+	}
+	publishDesktop(client);
+
+	return client;
+}
+
+void Core::unmanage(const Client &client) {
+	LogDebug << "Unframed Window: " << client.window << '\n';
+	if(_hiding == Config::Container) {
+		//Containers sit at the origin, so positions carry over unchanged
+		_backend.reparent(client.window, None, client.position);
+		_backend.saveSet(client.window, false);
+	}
+	_backend.setDesktop(client.window, -1);
+	erase(client.window);
+	focusLast();
+}
+
+void Core::map(const std::vector<Window> &windows, const std::vector<Window> &framed) {
+	//Tiles are settled before anything shows up on screen, on the current
+	//workspace and whichever ones rules sent clients to
+	std::array<bool, nWorkspaces> affected{};
+	for(Window w : framed) {
+		if(auto client = find(w) ) affected[client->workspace] = true;
+	}
+	for(int ws = 0; ws < nWorkspaces; ws++) {
+		if(affected[ws]) relayout(ws);
+	}
+
+	//Windows show up where they belong, not where they asked to be
+	commitGeometry();
+	crossing();
+
+	for(Window w : windows) {
+		auto client = find(w);
+		if(client && client->iconic) continue;	//Ruled onto a hidden workspace
+		_backend.map(w);
+		if(client) client->mapped = true;
+	}
+}
+
+void Core::release() {
+	//Whatever wm comes next should find every window where it can see it,
+	//past the last commit, so moved windows go straight to their position
+	commitGeometry();
+	for(auto &c : _clients) {
+		if(c.workspace == _currentWorkspace) continue;
+		if(_hiding == Config::Move) {
+			_backend.configure(c.window, CWX | CWY, c.position, c.size);
+		} else {
+			show(c);
+		}
+	}
+
+	while(!_clients.empty() ) {
+		unmanage(*_clients.first() );
+	}
+}
+
+void Core::dock(Vector2 position, Vector2 size) {
+	if(position.y == 0) {
+		_upperBorder = size.y;
+	} else {
+		_lowerBorder = size.y;
+	}
+}
+
+void Core::createContainers() {
+	if(_hiding != Config::Container) return;
+
+	for(auto &container : _containers) {
+		container = _backend.createContainer();
+	}
+	_backend.map(_containers[_currentWorkspace]);
+}
+
+void Core::focus(Client &client) {
+	LogDebug << "Focusing " << client.window << '\n';
+	_focused = client.handle;
+	_focusDirty = true;
+}
+
+void Core::focusLast() {
+	if(auto last = _clients.last(_currentWorkspace) ) {
+		focus(*last);
+		return;
+	}
+
+	_focused = {};
+	_focusDirty = true;
+}
+
+void Core::focusNext() {
+	auto current = focused();
+	if(!current) return;
+
+	auto next = _clients.nextOnWorkspace(*current);
+	focus(next ? *next : *_clients.first(current->workspace) );
+}
+
+void Core::focusPrev() {
+	auto current = focused();
+	if(!current) return;
+
+	auto prev = _clients.prevOnWorkspace(*current);
+	focus(prev ? *prev : *_clients.last(current->workspace) );
+}
+
+void Core::activate(Client &client) {
+	if(client.workspace != _currentWorkspace) {
+		switchWorkspace(client.workspace);
+	}
+	focus(client);
+}
+
+void Core::switchWorkspace(int workspace) {
+	_metrics.workspaceSwitch();
+
+	if(_hiding == Config::Container) {
+		//Clients go along with their container, however many there are.
+		//Mapping first means the background never shows in between.
+		if(workspace != _currentWorkspace) {
+			commitGeometry();	//Settled before it shows
+			crossing();
+			_backend.map(_containers[workspace]);
+			_backend.unmap(_containers[_currentWorkspace]);
+		}
+		_currentWorkspace = workspace;
+	} else {
+		for(auto c = _clients.first(_currentWorkspace); c; c = _clients.nextOnWorkspace(*c) ) {
+			hide(*c);
+		}
+
+		_currentWorkspace = workspace;
+
+		for(auto c = _clients.first(_currentWorkspace); c; c = _clients.nextOnWorkspace(*c) ) {
+			show(*c);
+		}
+	}
+
+	_desktopDirty = true;
+	focusLast();
+	printLayout();
+}
+
+void Core::moveClient(Client &client, int workspace) {
+	if(client.workspace == workspace) return;
+	const int from = client.workspace;
+	_clients.move(client, workspace);
+	hide(client);
+	publishDesktop(client);
+	relayout(from);
+	relayout(workspace);
+	focusLast();
+}
+
+int Core::workspaceMap(Direction dir) const {
+	if(dir < Left || dir > Down) return _currentWorkspace;
+	return Workspaces::graph.next[_currentWorkspace][dir];
+}
+
+int Core::currentWorkspace() const {
+	return _currentWorkspace;
+}
+
+Layout::Mode Core::layout(int workspace) const {
+	return _layouts[workspace];
+}
+
+void Core::setLayout(int workspace, Layout::Mode mode) {
+	_layouts[workspace] = mode;
+	relayout(workspace);
+}
+
+void Core::zoomClient(Client &client) {
+	if(client.fullscreen) {
+		client.size = client.restoreSize;
+		client.position = client.restore;
+	} else {
+		const Layout::Geometry area = workArea();
+		client.restoreSize = client.size;
+		client.restore = client.position;
+		client.size = area.size;
+		client.position = area.position;
+	}
+
+	markDirty(client);
+	client.fullscreen ^= 1;
+	relayout(client.workspace);
+}
+
+void Core::relayout(int workspace) {
+	const Layout::Mode mode = _layouts[workspace];
+	if(mode == Layout::Floating) return;
+
+	//Zoomed and floating clients stay on top of the tiles
+	size_t count = 0;
+	for(auto c = _clients.first(workspace); c; c = _clients.nextOnWorkspace(*c) ) {
+		count += !c->fullscreen && !c->floating;
+	}
+
+	const Layout::Geometry area = workArea();
+	size_t index = 0;
+	for(auto c = _clients.first(workspace); c; c = _clients.nextOnWorkspace(*c) ) {
+		if(c->fullscreen || c->floating) continue;
+		configure(*c, Layout::tile(mode, area, count, index++) );
+	}
+}
+
+void Core::configure(Client &client, const Layout::Geometry &g) {
+	if(g.position.x == client.position.x && g.position.y == client.position.y
+			&& g.size.x == client.size.x && g.size.y == client.size.y) {
+		return;	//Nothing the server is not already getting
+	}
+
+	client.position = g.position;
+	client.size = g.size;
+	markDirty(client);
+}
+
+Layout::Geometry Core::allowed(const Client &client, const Layout::Geometry &requested) const {
+	//Zoomed and tiled clients stay put, floating ones stay on their workspace
+	if(!client.fullscreen && (client.floating
+				|| _layouts[client.workspace] == Layout::Floating) ) {
+		return clamp(requested);
+	}
+	return {client.position, client.size};
+}
+
+void Core::configured(Client &client, Vector2 position, Vector2 size, unsigned long serial) {
+	//Answers a request wm has since replaced, say the hiding move of a
+	//client switched back to, taking it would add the offset once more
+	if(serial < client.sentSerial) return;
+
+	client.sentPosition = position;
+	client.sentSize = size;
+	if(client.geometryDirty) return;	//Stale, a newer geometry is about to go out
+
+	client.size = size;
+
+	//Moves of hidden clients are the hiding itself, not a new position
+	if(client.workspace == _currentWorkspace) {
+		client.position = position;
+	}
+}
+
+void Core::markDirty(Client &client) {
+	if(client.geometryDirty) return;
+	client.geometryDirty = true;
+	_dirty.push_back(client.handle);
+}
+
+//Mirrors a restack of w in _stacking, a sibling of None means all of them.
+//TopIf, BottomIf and Opposite depend on overlaps and are not tracked.
+void Core::restack(Window w, int mode, Window sibling) {
+	if(mode != Above && mode != Below) return;
+
+	auto it = std::find(_stacking.begin(), _stacking.end(), w);
+	if(it == _stacking.end() ) return;
+
+	if(sibling == None && it == (mode == Above ? _stacking.end() - 1 : _stacking.begin() ) ) {
+		return;	//Already there, the common case of raising the focused client
+	}
+
+	_stacking.erase(it);
+	auto at = mode == Above ? _stacking.end() : _stacking.begin();
+	if(sibling != None) {
+		at = std::find(_stacking.begin(), _stacking.end(), sibling);
+		if(at == _stacking.end() ) {
+			at = _stacking.end();	//Not a client, keep it on top
+		} else if(mode == Above) {
+			at++;
+		}
+	}
+	_stacking.insert(at, w);
+	_stackingDirty = true;
+}
+
+//Handlers only record what should change. Once a batch of events is
+//drained, the final state is sent here: one configure per moved or
+//resized client, focus once, every root property at most once, then one
+//flush. Whatever a later event in the batch superseded is never sent.
+void Core::commit() {
+	commitGeometry();
+	commitFocus();	//Raising may restack
+
+	if(_desktopDirty) {
+		_backend.setCurrentDesktop(_currentWorkspace);
+		_desktopDirty = false;
+	}
+
+	if(_clientListDirty) {
+		std::vector<Window> windows;
+		windows.reserve(_clients.size() );
+		for(auto c = _clients.first(); c; c = _clients.next(*c) ) {
+			windows.push_back(c->window);
+		}
+		_backend.setList(Backend::ClientList, windows.data(), windows.size(), false);
+		_clientListDirty = false;
+	}
+
+	if(_stackingDirty) {
+		_backend.setList(Backend::ClientListStacking, _stacking.data(), _stacking.size(), false);
+		_stackingDirty = false;
+	}
+
+	//Crossings from here on are the user's doing, which a no-op puts a
+	//serial on that is past everything the commit sent
+	if(_crossing) {
+		_crossings.push_back({_crossingStart, _backend.nextRequest()});
+		_backend.noOp();
+		if(_crossings.size() > maxCrossings) _crossings.pop_front();
+		_crossing = false;
+	}
+
+	_backend.flush();
+}
+
+void Core::commitGeometry() {
+	for(Handle h : _dirty) {
+		if(auto client = _clients.get(h); client && client->geometryDirty) {
+			sendGeometry(*client);
+		}
+	}
+	_dirty.clear();
+}
+
+bool Core::caused(unsigned long serial) {
+	while(!_crossings.empty() && _crossings.front().second <= serial) {
+		_crossings.pop_front();
+	}
+	if(!_crossings.empty() && _crossings.front().first <= serial) return true;
+
+	//The batch still being handled may have been flushed already, XPending
+	//does so, and then its crossings arrive before commit() closes them
+	return _crossing && serial >= _crossingStart;
+}
+
+Client *Core::find(Window w) {
+	return _clients.find(w);
+}
+
+Client *Core::focused() {
+	return _clients.get(_focused);
+}
+
+Core::Clients &Core::clients() {
+	return _clients;
+}
+
+void Core::hide(Client &client) {
+	if(_hiding == Config::Container) {
+		reparent(client);	//Hidden along with its new container
+		return;
+	}
+
+	if(_hiding == Config::Iconify) {
+		if(client.iconic) return;
+		client.iconic = true;
+		if(client.mapped) {
+			client.mapped = false;
+			client.ignoreUnmaps++;
+			crossing();
+			_backend.unmap(client.window);
+		}
+		setState(client, IconicState);
+		return;
+	}
+
+	//Big brain window hide, the offset is added when the batch is committed
+	markDirty(client);
+}
+
+void Core::show(Client &client) {
+	if(_hiding == Config::Container) return;	//Shown along with its container
+
+	if(_hiding == Config::Iconify) {
+		if(!client.iconic) return;
+		client.iconic = false;
+		client.mapped = true;
+		if(client.geometryDirty) sendGeometry(client);	//Settled before it shows
+		crossing();
+		_backend.map(client.window);
+		setState(client, NormalState);
+		return;
+	}
+
+	markDirty(client);
+}
+
+void Core::reparent(Client &client) {
+	//A mapped window is unmapped and mapped again on the way
+	if(client.mapped) client.ignoreUnmaps++;
+	crossing();
+	client.sentSerial = _backend.nextRequest();
+	_backend.reparent(client.window, _containers[client.workspace], client.position);
+	client.sentPosition = client.position;
+}
+
+//WM_STATE, with _NET_WM_STATE_HIDDEN following it. Every other state the
+//client asked for is kept as it is.
+void Core::setState(Client &client, long state) {
+	std::vector<Atom> &netState = client.properties.netState;
+	const Atom hidden = _netAtoms.WMStateHidden;
+	const auto it = std::find(netState.begin(), netState.end(), hidden);
+	if(state == IconicState && it == netState.end() ) {
+		netState.push_back(hidden);
+	} else if(state != IconicState && it != netState.end() ) {
+		netState.erase(it);
+	}
+	_backend.setState(client.window, state, netState);
+}
+
+void Core::erase(Window w) {
+	auto client = find(w);
+	if(!client) return;
+
+	const int workspace = client->workspace;
+	_clients.erase(w);
+	if(auto it = std::find(_stacking.begin(), _stacking.end(), w); it != _stacking.end() ) {
+		_stacking.erase(it);
+	}
+	_clientListDirty = _stackingDirty = true;
+	relayout(workspace);
+}
+
+void Core::commitFocus() {
+	if(!_focusDirty) return;
+	_focusDirty = false;
+
+	auto client = focused();
+	if(!client) {
+		_backend.setActiveWindow(None);
+		_backend.focus(None);
+		return;
+	}
+
+	_backend.setActiveWindow(client->window);
+	crossing();
+	_backend.raise(client->window);
+	restack(client->window, Above, None);
+	_backend.focus(client->window);
+}
+
+//Move and resize merged into one request, only with what actually changed
+void Core::sendGeometry(Client &client) {
+	client.geometryDirty = false;
+
+	const Vector2 offset = client.workspace == _currentWorkspace
+		? Vector2{} : hiddenOffset();
+	const Vector2 position = client.position + offset;
+	unsigned int mask = 0;
+
+	if(position.x != client.sentPosition.x) mask |= CWX;
+	if(position.y != client.sentPosition.y) mask |= CWY;
+	if(client.size.x != client.sentSize.x) mask |= CWWidth;
+	if(client.size.y != client.sentSize.y) mask |= CWHeight;
+
+	if(mask) {
+		crossing();
+		client.sentSerial = _backend.nextRequest();
+		_backend.configure(client.window, mask, position, client.size);
+		client.sentPosition = position;
+		client.sentSize = client.size;
+	}
+
+	//A real ConfigureNotify only follows a resize, ICCCM wants one either way
+	if(client.notify) {
+		client.notify = false;
+		if(!(mask & (CWWidth | CWHeight) ) ) _backend.notify(client.window, position, client.size);
+	}
+}
+
+//Notes that the requests about to go out may move windows under the
+//pointer. The EnterNotify events they cause carry their serials.
+void Core::crossing() {
+	if(_crossing) return;
+	_crossing = true;
+	_crossingStart = _backend.nextRequest();
+}
+
+//A new client goes last in mapping order and on top of the stack, which
+//an append expresses unless a rewrite is due anyway
+void Core::publishClient(Window w) {
+	_stacking.push_back(w);
+
+	if(!_clientListDirty) {
+		_backend.setList(Backend::ClientList, &w, 1, true);
+	}
+	if(!_stackingDirty) {
+		_backend.setList(Backend::ClientListStacking, &w, 1, true);
+	}
+}
+
+void Core::publishDesktop(const Client &client) {
+	_backend.setDesktop(client.window, client.workspace);
+}
+
+Layout::Geometry Core::workArea() const {
+	constexpr int border2W = static_cast<int>(borderWidth << 1);
+	return {{0, _upperBorder}, {_screen.x - border2W,
+		_screen.y - border2W - (_lowerBorder + _upperBorder)}};
+}
+
+Layout::Geometry Core::clamp(const Layout::Geometry &g) const {
+	const Layout::Geometry area = workArea();
+	Layout::Geometry clamped = g;
+
+	clamped.size.x = std::min(g.size.x, area.size.x);
+	clamped.size.y = std::min(g.size.y, area.size.y);
+	clamped.position.x = std::clamp(g.position.x, area.position.x,
+			area.position.x + area.size.x - clamped.size.x);
+	clamped.position.y = std::clamp(g.position.y, area.position.y,
+			area.position.y + area.size.y - clamped.size.y);
+	return clamped;
+}
+
+Vector2 Core::hiddenOffset() const {
+	//Iconified and contained windows are out of sight wherever they are
+	if(_hiding != Config::Move) return {};
+	return _screen;
+}
+
+void Core::printLayout() const {
+	if(!Logger::enabled(Logger::Debug) ) return;
+
+	std::string layout;
+	for(int ws = 0; ws < nWorkspaces; ws++) {
+		const std::string_view name = Workspaces::graph.names[ws].view();
+		if(ws == _currentWorkspace) {
+			layout.append(" [").append(name).append("]");
+		} else {
+			layout.append(" ").append(name);
+		}
+	}
+	LogDebug << "Layout:" << layout << '\n';
+}
@@ -0,0 +1,166 @@
+#include "event_loop.hpp"
+
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+#include <sys/inotify.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <csignal>
+#include <cstdint>
+#include <cerrno>
+#include <array>
+
+constexpr static int maxEvents = 16;
+
+std::unique_ptr<EventLoop> EventLoop::create() {
+	int fd = epoll_create1(EPOLL_CLOEXEC);
+	if(fd < 0) return nullptr;
+
+	return std::unique_ptr<EventLoop>(new EventLoop(fd) );
+}
+
+EventLoop::EventLoop(int fd) 
+	: _fd(fd) {
+}
+
+EventLoop::~EventLoop() {
+	close(_fd);
+}
+
+bool EventLoop::watch(int fd, Callback callback) {
+	epoll_event ev = {};
+	ev.events = EPOLLIN;
+	ev.data.fd = fd;
+
+	if(epoll_ctl(_fd, EPOLL_CTL_ADD, fd, &ev) < 0) return false;
+
+	_callbacks[fd] = std::move(callback);
+	return true;
+}
+
+void EventLoop::unwatch(int fd) {
+	epoll_ctl(_fd, EPOLL_CTL_DEL, fd, nullptr);
+	_callbacks.erase(fd);
+}
+
+void EventLoop::wait() {
+	std::array<epoll_event, maxEvents> events;
+
+	int n = epoll_wait(_fd, events.data(), maxEvents, -1);
+
+	for(int i = 0; i < n; i++) {
+		auto it = _callbacks.find(events[i].data.fd);
+		if(it == _callbacks.end() ) continue;	//Unwatched by an earlier callback
+
+		//Copied, the callback may well unwatch itself
+		Callback callback = it->second;
+		callback();
+	}
+}
+
+Timer::Timer() 
+	: _fd(timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC) ) {
+}
+
+Timer::~Timer() {
+	close(_fd);
+}
+
+int Timer::fd() const {
+	return _fd;
+}
+
+bool Timer::armed() const {
+	return _armed;
+}
+
+void Timer::arm(std::chrono::nanoseconds delay) {
+	//A zero it_value would disarm, fire right away instead
+	const auto ns = std::max<long long>(delay.count(), 1);
+
+	itimerspec spec = {};
+	spec.it_value.tv_sec = static_cast<time_t>(ns / 1000000000);
+	spec.it_value.tv_nsec = static_cast<long>(ns % 1000000000);
+
+	timerfd_settime(_fd, 0, &spec, nullptr);
+	_armed = true;
+}
+
+void Timer::disarm() {
+	const itimerspec spec = {};
+	timerfd_settime(_fd, 0, &spec, nullptr);
+	_armed = false;
+}
+
+void Timer::acknowledge() {
+	uint64_t expirations;
+	while(read(_fd, &expirations, sizeof(expirations) ) > 0);
+	_armed = false;
+}
+
+Signals::Signals(std::initializer_list<int> signals) {
+	sigset_t mask;
+	sigemptyset(&mask);
+	for(int signal : signals) {
+		sigaddset(&mask, signal);
+	}
+
+	sigprocmask(SIG_BLOCK, &mask, nullptr);
+	_fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+}
+
+Signals::~Signals() {
+	close(_fd);
+}
+
+int Signals::fd() const {
+	return _fd;
+}
+
+int Signals::next() {
+	signalfd_siginfo info;
+	if(read(_fd, &info, sizeof(info) ) != sizeof(info) ) return 0;
+	return static_cast<int>(info.ssi_signo);
+}
+
+FileWatch::FileWatch(const std::string &path) {
+	const size_t slash = path.rfind('/');
+	const std::string dir = slash == std::string::npos ? "." 
+		: slash == 0 ? "/" : path.substr(0, slash);
+	_name = path.substr(slash == std::string::npos ? 0 : slash + 1);
+
+	_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if(_fd < 0) return;
+
+	if(inotify_add_watch(_fd, dir.c_str(), 
+				IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE) < 0) {
+		close(_fd);
+		_fd = -1;
+	}
+}
+
+FileWatch::~FileWatch() {
+	if(_fd >= 0) close(_fd);
+}
+
+int FileWatch::fd() const {
+	return _fd;
+}
+
+bool FileWatch::changed() {
+	alignas(inotify_event) char buf[4096];
+	bool changed = false;
+	ssize_t n;
+
+	while((n = read(_fd, buf, sizeof(buf) ) ) > 0) {
+		for(ssize_t i = 0; i < n; ) {
+			const auto event = reinterpret_cast<const inotify_event*>(buf + i);
+			if(event->len && _name == event->name) changed = true;
+			i += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+		}
+	}
+
+	return changed;
+}
@@ -0,0 +1,175 @@
+#include "ipc.hpp"
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+
+//Requests are short commands, anything longer is not talking to us
+constexpr static size_t maxRequestLength = 1024;
+constexpr static int backlog = 16;
+constexpr static timeval replyTimeout = {1, 0};
+
+std::string Ipc::socketPath() {
+	const char *display = std::getenv("DISPLAY");
+	std::string name = display ? display : ":0";
+	std::replace(name.begin(), name.end(), '/', '_');
+
+	if(const char *runtime = std::getenv("XDG_RUNTIME_DIR"); runtime && *runtime) {
+		return std::string(runtime) + "/wm" + name + ".sock";
+	}
+
+	return "/tmp/wm-" + std::to_string(getuid() ) + name + ".sock";
+}
+
+bool Ipc::request(std::string_view line, std::string &reply) {
+	const std::string path = socketPath();
+	sockaddr_un addr = {};
+	if(path.size() >= sizeof(addr.sun_path) ) return false;
+
+	addr.sun_family = AF_UNIX;
+	std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+	int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if(fd < 0) return false;
+
+	if(connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr) ) < 0) {
+		close(fd);
+		return false;
+	}
+
+	setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &replyTimeout, sizeof(replyTimeout) );
+
+	std::string message(line);
+	message += '\n';
+	if(send(fd, message.data(), message.size(), MSG_NOSIGNAL) 
+			!= static_cast<ssize_t>(message.size() ) ) {
+		close(fd);
+		return false;
+	}
+	shutdown(fd, SHUT_WR);
+
+	reply.clear();
+	char buf[4096];
+	ssize_t n;
+	while((n = recv(fd, buf, sizeof(buf), 0) ) > 0) {
+		reply.append(buf, static_cast<size_t>(n) );
+	}
+
+	close(fd);
+	return n == 0;
+}
+
+std::unique_ptr<IpcServer> IpcServer::create(const std::string &path, 
+		EventLoop &loop, Handler handler) {
+	sockaddr_un addr = {};
+	if(path.size() >= sizeof(addr.sun_path) ) return nullptr;
+
+	addr.sun_family = AF_UNIX;
+	std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+
+	int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if(fd < 0) return nullptr;
+
+	//Only reached once no other wm owns the display, so this one is stale
+	unlink(path.c_str() );
+
+	//Created owner only, a chmod afterwards would leave a window in which
+	//any local user could connect
+	const mode_t mask = umask(S_IXUSR | S_IRWXG | S_IRWXO);
+	const bool bound = bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr) ) == 0;
+	umask(mask);
+
+	if(!bound || listen(fd, backlog) < 0) {
+		close(fd);
+		return nullptr;
+	}
+
+	std::unique_ptr<IpcServer> server(new IpcServer(fd, path, loop, std::move(handler) ) );
+	if(!loop.watch(fd, [s = server.get()]() { s->accept(); }) ) {
+		return nullptr;
+	}
+
+	return server;
+}
+
+IpcServer::IpcServer(int fd, const std::string &path, EventLoop &loop, Handler handler) 
+	: _fd(fd), _path(path), _loop(loop), _handler(std::move(handler) ) {
+}
+
+IpcServer::~IpcServer() {
+	while(!_connections.empty() ) {
+		drop(_connections.begin()->first);
+	}
+
+	_loop.unwatch(_fd);
+	close(_fd);
+	unlink(_path.c_str() );
+}
+
+void IpcServer::accept() {
+	int fd;
+	while((fd = accept4(_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC) ) >= 0) {
+		if(!_loop.watch(fd, [this, fd]() { read(fd); }) ) {
+			close(fd);
+			continue;
+		}
+		_connections[fd];
+	}
+}
+
+void IpcServer::read(int fd) {
+	std::string &buffer = _connections[fd];
+	char buf[256];
+	ssize_t n;
+
+	while((n = recv(fd, buf, sizeof(buf), 0) ) > 0) {
+		buffer.append(buf, static_cast<size_t>(n) );
+		if(buffer.size() > maxRequestLength) {
+			drop(fd);
+			return;
+		}
+	}
+
+	if(n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) ) {
+		//Not a full line yet, wait for more
+		if(buffer.find('\n') == std::string::npos) return;
+	} else if(n < 0) {
+		drop(fd);
+		return;
+	}
+
+	std::string_view request = buffer;
+	request = request.substr(0, request.find('\n') );
+	if(!request.empty() ) {
+		reply(fd, _handler(request) );
+	}
+
+	drop(fd);
+}
+
+void IpcServer::reply(int fd, const std::string &reply) {
+	//Replies are small and the peer is waiting for them, so write them
+	//out right away, bounded by a timeout
+	fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_NONBLOCK);
+	setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &replyTimeout, sizeof(replyTimeout) );
+
+	size_t written = 0;
+	while(written < reply.size() ) {
+		ssize_t n = send(fd, reply.data() + written, reply.size() - written, MSG_NOSIGNAL);
+		if(n <= 0) break;
+		written += static_cast<size_t>(n);
+	}
+}
+
+void IpcServer::drop(int fd) {
+	_loop.unwatch(fd);
+	_connections.erase(fd);
+	close(fd);
+}
@@ -0,0 +1,62 @@
+#include "layout.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+//Master column width, in percent of the area
+constexpr static int masterPercent = 55;
+
+//Span i out of n equal spans of length, remainders spread over the spans
+static void split(int start, int length, size_t n, size_t i, int &pos, int &span) {
+	const long long l = length;
+	const long long from = l * static_cast<long long>(i) / static_cast<long long>(n);
+	const long long to = l * static_cast<long long>(i + 1) / static_cast<long long>(n);
+	pos = start + static_cast<int>(from);
+	span = static_cast<int>(to - from);
+}
+
+size_t Layout::gridColumns(size_t count) {
+	//Ceiling of the square root, corrected for floating point rounding
+	size_t columns = static_cast<size_t>(std::sqrt(static_cast<double>(count) ) );
+	while(columns * columns < count) {
+		columns++;
+	}
+	while(columns > 1 && (columns - 1) * (columns - 1) >= count) {
+		columns--;
+	}
+	return std::max<size_t>(columns, 1);
+}
+
+Layout::Geometry Layout::tile(Mode mode, const Geometry &area, size_t count, size_t index) {
+	Geometry g = area;
+	if(count <= 1) return g;
+
+	switch(mode) {
+		case MasterStack: {
+			const int masterWidth = area.size.x * masterPercent / 100;
+			if(index == 0) {
+				g.size.x = masterWidth;
+				break;
+			}
+
+			g.position.x = area.position.x + masterWidth;
+			g.size.x = area.size.x - masterWidth;
+			split(area.position.y, area.size.y, count - 1, index - 1, g.position.y, g.size.y);
+			break;
+		}
+		case Grid: {
+			const size_t columns = gridColumns(count);
+			const size_t rows = (count + columns - 1) / columns;
+			const size_t row = index / columns;
+			const size_t inRow = row + 1 == rows ? count - row * columns : columns;
+
+			split(area.position.x, area.size.x, inRow, index % columns, g.position.x, g.size.x);
+			split(area.position.y, area.size.y, rows, row, g.position.y, g.size.y);
+			break;
+		}
+		default:
+			break;
+	}
+
+	return g;
+}
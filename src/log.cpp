@@ -0,0 +1,270 @@
+#include "log.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <thread>
+
+std::atomic<int> Logger::threshold{Logger::Error};
+
+namespace {
+
+constexpr size_t ringSize = 4096;	//Power of two
+
+//Bounded multi-producer, single-consumer ring. Every slot carries a
+//sequence number telling whose turn it is, so producers only contend on
+//the head index and never wait for the writer thread.
+class Ring {
+	public:
+		Ring() {
+			for(size_t i = 0; i < ringSize; i++) {
+				_slots[i].sequence.store(i, std::memory_order_relaxed);
+			}
+		}
+
+		bool push(const Logger::Entry &entry) {
+			size_t pos = _head.load(std::memory_order_relaxed);
+			Slot *slot;
+
+			for(;;) {
+				slot = &_slots[pos & (ringSize - 1)];
+				const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+				const auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+
+				if(diff == 0) {
+					if(_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed) ) {
+						break;
+					}
+				} else if(diff < 0) {
+					_dropped.fetch_add(1, std::memory_order_relaxed);
+					return false;	//Full, the writer fell behind
+				} else {
+					pos = _head.load(std::memory_order_relaxed);
+				}
+			}
+
+			//Only the used part of the text is copied
+			std::memcpy(&slot->entry, &entry, offsetof(Logger::Entry, text) + entry.length);
+			slot->sequence.store(pos + 1, std::memory_order_release);
+			return true;
+		}
+
+		bool pop(Logger::Entry &entry) {
+			Slot &slot = _slots[_tail & (ringSize - 1)];
+			if(slot.sequence.load(std::memory_order_acquire) != _tail + 1) {
+				return false;
+			}
+
+			std::memcpy(&entry, &slot.entry, offsetof(Logger::Entry, text) + slot.entry.length);
+			slot.sequence.store(_tail + ringSize, std::memory_order_release);
+			_tail++;
+			return true;
+		}
+
+		//Whether pop() has something, writer thread only
+		bool ready() const {
+			const Slot &slot = _slots[_tail & (ringSize - 1)];
+			return slot.sequence.load(std::memory_order_acquire) == _tail + 1;
+		}
+
+		size_t dropped() {
+			return _dropped.exchange(0, std::memory_order_relaxed);
+		}
+
+	private:
+		struct Slot {
+			std::atomic<size_t> sequence;
+			Logger::Entry entry;
+		};
+
+		Slot _slots[ringSize];
+		alignas(64) std::atomic<size_t> _head{0};
+		alignas(64) size_t _tail = 0;	//Writer thread only
+		std::atomic<size_t> _dropped{0};
+};
+
+//Owns the writer thread. Started by the first record, drained and joined
+//when the process exits.
+class Writer {
+	public:
+		static Writer &instance() {
+			static Writer writer;
+			return writer;
+		}
+
+		//The mutex is only taken to wake the writer once it went to sleep
+		//on an empty ring, so a busy writer costs producers nothing extra
+		void submit(const Logger::Entry &entry) {
+			_ring.push(entry);
+
+			std::atomic_thread_fence(std::memory_order_seq_cst);	//Pairs with run()
+			if(_sleeping.load(std::memory_order_relaxed) ) {
+				std::lock_guard<std::mutex> lock(_mutex);
+				_wake.notify_one();
+			}
+		}
+
+	private:
+		Writer() : _thread(&Writer::run, this) {
+		}
+
+		~Writer() {
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				_running.store(false, std::memory_order_release);
+			}
+			_wake.notify_one();
+			_thread.join();
+		}
+
+		void run() {
+			while(_running.load(std::memory_order_acquire) ) {
+				if(drain() ) continue;
+
+				//Either submit() sees _sleeping and wakes us, or the entry it
+				//pushed is visible to ready() below
+				std::unique_lock<std::mutex> lock(_mutex);
+				_sleeping.store(true, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				_wake.wait(lock, [this]() {
+					return _ring.ready() || !_running.load(std::memory_order_acquire);
+				});
+				_sleeping.store(false, std::memory_order_relaxed);
+			}
+
+			//Whatever was logged before exit still goes out
+			while(drain() ) {
+			}
+		}
+
+		//Writes out everything queued, false if there was nothing
+		bool drain() {
+			Logger::Entry entry;
+			bool any = false;
+
+			while(_ring.pop(entry) ) {
+				format(entry, entry.level == Logger::Debug ? _out : _err);
+				any = true;
+			}
+
+			if(const size_t dropped = _ring.dropped() ) {
+				_err += "Logger: dropped " + std::to_string(dropped) + " record(s)\n";
+				any = true;
+			}
+
+			write(_out, stdout);
+			write(_err, stderr);
+			return any;
+		}
+
+		static void format(const Logger::Entry &entry, std::string &out) {
+			const time_t seconds = static_cast<time_t>(entry.time / 1000000000);
+			const unsigned micros = static_cast<unsigned>(entry.time % 1000000000 / 1000);
+			tm local;
+			localtime_r(&seconds, &local);
+
+			char stamp[32];
+			std::snprintf(stamp, sizeof(stamp), "%02d:%02d:%02d.%06u ",
+					local.tm_hour, local.tm_min, local.tm_sec, micros);
+
+			out += stamp;
+			out += "File:";
+			out += entry.file;
+			out += " Line:";
+			out += std::to_string(entry.line);
+			out += ' ';
+			out.append(entry.text, entry.length);
+		}
+
+		static void write(std::string &buffer, FILE *stream) {
+			if(buffer.empty() ) return;
+			std::fwrite(buffer.data(), 1, buffer.size(), stream);
+			std::fflush(stream);
+			buffer.clear();
+		}
+
+		Ring _ring;
+		std::string _out, _err;
+		std::mutex _mutex;
+		std::condition_variable _wake;
+		std::atomic<bool> _sleeping{false};	//Waiting on _wake for an entry
+		std::atomic<bool> _running{true};
+		std::thread _thread;	//Last, everything above is ready when it starts
+};
+
+}
+
+void Logger::setLevel(Level level) {
+	threshold.store(level, std::memory_order_relaxed);
+}
+
+bool Logger::parseLevel(std::string_view name, Level &level) {
+	constexpr std::string_view names[] = {"debug", "error", "off"};
+
+	for(size_t i = 0; i < std::size(names); i++) {
+		if(names[i] == name) {
+			level = static_cast<Level>(i);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+Logger::Record::Record(Level level, const char *file, int line) {
+	using namespace std::chrono;
+	_entry.time = static_cast<uint64_t>(duration_cast<nanoseconds>(
+				system_clock::now().time_since_epoch() ).count() );
+	_entry.file = file;
+	_entry.line = static_cast<uint32_t>(line);
+	_entry.length = 0;
+	_entry.level = static_cast<uint8_t>(level);
+}
+
+Logger::Record::~Record() {
+	Writer::instance().submit(_entry);
+}
+
+Logger::Record &Logger::Record::operator<<(std::string_view str) {
+	const size_t n = std::min(str.size(), Entry::capacity - _entry.length);
+	std::memcpy(_entry.text + _entry.length, str.data(), n);
+	_entry.length = static_cast<uint16_t>(_entry.length + n);
+	return *this;
+}
+
+//Literals would otherwise pick the bool overload
+Logger::Record &Logger::Record::operator<<(const char *str) {
+	return *this << std::string_view(str);
+}
+
+Logger::Record &Logger::Record::operator<<(char c) {
+	return *this << std::string_view(&c, 1);
+}
+
+Logger::Record &Logger::Record::operator<<(bool b) {
+	return *this << (b ? std::string_view("true") : std::string_view("false") );
+}
+
+Logger::Record &Logger::Record::operator<<(double d) {
+	char buf[32];
+	const int n = std::snprintf(buf, sizeof(buf), "%g", d);
+	return *this << std::string_view(buf, static_cast<size_t>(std::max(n, 0) ) );
+}
+
+Logger::Record &Logger::Record::integer(long long value) {
+	char buf[24];
+	const auto result = std::to_chars(buf, buf + sizeof(buf), value);
+	return *this << std::string_view(buf, static_cast<size_t>(result.ptr - buf) );
+}
+
+Logger::Record &Logger::Record::integer(unsigned long long value) {
+	char buf[24];
+	const auto result = std::to_chars(buf, buf + sizeof(buf), value);
+	return *this << std::string_view(buf, static_cast<size_t>(result.ptr - buf) );
+}
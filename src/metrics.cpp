@@ -0,0 +1,161 @@
+#include "metrics.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+//Core protocol event names, indexed by event type
+constexpr static std::array<const char*, LASTEvent> eventNames = {{
+	"Error", "Reply", "KeyPress", "KeyRelease", "ButtonPress", "ButtonRelease",
+	"MotionNotify", "EnterNotify", "LeaveNotify", "FocusIn", "FocusOut",
+	"KeymapNotify", "Expose", "GraphicsExpose", "NoExpose", "VisibilityNotify",
+	"CreateNotify", "DestroyNotify", "UnmapNotify", "MapNotify", "MapRequest",
+	"ReparentNotify", "ConfigureNotify", "ConfigureRequest", "GravityNotify",
+	"ResizeRequest", "CirculateNotify", "CirculateRequest", "PropertyNotify",
+	"SelectionClear", "SelectionRequest", "SelectionNotify", "ColormapNotify",
+	"ClientMessage", "MappingNotify", "GenericEvent"
+}};
+
+void Histogram::record(uint64_t ns) {
+	//Smallest i with 2^i > ns is the bit width of ns
+	size_t bucket = ns ? 64 - static_cast<size_t>(__builtin_clzll(ns) ) : 0;
+	if(bucket >= nBuckets) bucket = nBuckets - 1;
+
+	_buckets[bucket]++;
+	_count++;
+	_sum += ns;
+	if(ns > _max) _max = ns;
+}
+
+uint64_t Histogram::count() const {
+	return _count;
+}
+
+uint64_t Histogram::quantile(double q) const {
+	if(!_count) return 0;
+
+	//Nearest rank
+	const uint64_t rank = static_cast<uint64_t>(
+			std::max(1.0, std::ceil(q * static_cast<double>(_count) ) ) ) - 1;
+	uint64_t seen = 0;
+
+	for(size_t i = 0; i < nBuckets; i++) {
+		seen += _buckets[i];
+		if(seen > rank) return std::min(uint64_t(1) << i, _max);
+	}
+
+	return _max;
+}
+
+void Histogram::json(std::string &out) const {
+	out += "{\"count\":" + std::to_string(_count)
+		+ ",\"sum_ns\":" + std::to_string(_sum)
+		+ ",\"max_ns\":" + std::to_string(_max)
+		+ ",\"p50_ns\":" + std::to_string(quantile(0.5) )
+		+ ",\"p99_ns\":" + std::to_string(quantile(0.99) )
+		+ ",\"buckets\":[";
+
+	//Only the populated buckets, as [upper bound, count]
+	bool first = true;
+	for(size_t i = 0; i < nBuckets; i++) {
+		if(!_buckets[i]) continue;
+		if(!first) out += ',';
+		out += '[' + std::to_string(uint64_t(1) << i) + ',' + std::to_string(_buckets[i]) + ']';
+		first = false;
+	}
+
+	out += "]}";
+}
+
+void Metrics::roundTrip(unsigned long n) {
+	_roundTrips += n;
+}
+
+unsigned long Metrics::roundTrips() const {
+	return _roundTrips;
+}
+
+void Metrics::event(int type, Clock::duration time, unsigned long roundTrips) {
+	if(type < 0 || type >= LASTEvent) return;
+
+	auto &handler = _events[type];
+	handler.latency.record(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count() );
+	handler.roundTrips += roundTrips;
+}
+
+void Metrics::command(long type, Clock::duration time, unsigned long roundTrips) {
+	auto &handler = _commands[type];
+	handler.latency.record(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count() );
+	handler.roundTrips += roundTrips;
+}
+
+void Metrics::query(long type, Clock::duration time, unsigned long roundTrips) {
+	auto &handler = _queries[type];
+	handler.latency.record(std::chrono::duration_cast<std::chrono::nanoseconds>(time).count() );
+	handler.roundTrips += roundTrips;
+}
+
+void Metrics::framed(unsigned long windows, unsigned long roundTrips) {
+	_framedWindows += windows;
+	_frameRoundTrips += roundTrips;
+}
+
+void Metrics::workspaceSwitch() {
+	_workspaceSwitches++;
+}
+
+void Metrics::configureRequest(Configure outcome) {
+	_configureRequests[outcome]++;
+}
+
+void Metrics::enterNotify(Enter outcome) {
+	_enterNotifies[outcome]++;
+}
+
+std::string Metrics::json(size_t clients) const {
+	std::string out = "{\"clients\":" + std::to_string(clients)
+		+ ",\"workspace_switches\":" + std::to_string(_workspaceSwitches)
+		+ ",\"round_trips\":" + std::to_string(_roundTrips)
+		+ ",\"framed_windows\":" + std::to_string(_framedWindows)
+		+ ",\"frame_round_trips\":" + std::to_string(_frameRoundTrips)
+		+ ",\"configure_requests\":{\"forwarded\":" + std::to_string(_configureRequests[Forwarded])
+		+ ",\"rewritten\":" + std::to_string(_configureRequests[Rewritten])
+		+ ",\"suppressed\":" + std::to_string(_configureRequests[Suppressed])
+		+ ",\"coalesced\":" + std::to_string(_configureRequests[Coalesced]) + '}'
+		+ ",\"enter_notify\":{\"followed\":" + std::to_string(_enterNotifies[Followed])
+		+ ",\"caused\":" + std::to_string(_enterNotifies[Caused])
+		+ ",\"grab\":" + std::to_string(_enterNotifies[Grab])
+		+ ",\"inferior\":" + std::to_string(_enterNotifies[Inferior]) + '}'
+		+ ",\"events\":{";
+
+	bool first = true;
+	for(size_t i = 0; i < _events.size(); i++) {
+		if(!_events[i].latency.count() ) continue;
+		if(!first) out += ',';
+		json(out, eventNames[i], _events[i]);
+		first = false;
+	}
+
+	out += "},\"commands\":{";
+	first = true;
+	auto commands = [&](const auto &handlers, auto name) {
+		for(size_t i = 0; i < handlers.size(); i++) {
+			if(!handlers[i].latency.count() ) continue;
+			if(!first) out += ',';
+			json(out, std::string(name(i) ).c_str(), handlers[i]);
+			first = false;
+		}
+	};
+	commands(_commands, [](size_t i) { return Event::options[i].name; });
+	commands(_queries, [](size_t i) { return Event::queries[i]; });
+
+	out += "}}\n";
+	return out;
+}
+
+void Metrics::json(std::string &out, const char *name, const Handler &handler) {
+	out += '"';
+	out += name;
+	out += "\":{\"round_trips\":" + std::to_string(handler.roundTrips) + ",\"latency\":";
+	handler.latency.json(out);
+	out += '}';
+}
@@ -0,0 +1,101 @@
+#include "properties.hpp"
+
+extern "C" {
+	#include <X11/Xatom.h>
+	#include <X11/Xutil.h>
+}
+
+#include <algorithm>
+
+//Replies are padded to whole words, 1024 words is plenty for WM_CLASS and titles
+constexpr static long maxStringLength = 1024;
+constexpr static long maxProtocols = 32;
+constexpr static long sizeHintsLength = 18;	//Fields of xPropSizeHints
+constexpr static long maxStates = 32;
+
+void Properties::set(Kind kind, const PropertyValue &value, const IccAtom &iccAtoms) {
+	const bool bytes = value.type != None && value.format == 8;
+	const bool longs = value.type != None && value.format == 32;
+
+	switch(kind) {
+		case WindowType:
+			windowType = longs && value.type == XA_ATOM && !value.values.empty()
+				? static_cast<Atom>(value.values.front() ) : None;
+			break;
+		case Class: {
+			//"res_name\0res_class\0"
+			const std::string none;
+			const std::string &str = bytes ? value.bytes : none;
+			const size_t split = str.find('\0');
+			resName = str.substr(0, split);
+			resClass = split == std::string::npos ? std::string() : str.c_str() + split + 1;
+			break;
+		}
+		case NetName:
+			netName = bytes;
+			if(bytes) title = value.bytes;
+			break;
+		case Name:
+			//_NET_WM_NAME takes precedence whenever it is there
+			if(!netName) title = bytes ? value.bytes : std::string();
+			break;
+		case Protocols:
+			deleteWindow = longs && std::find(value.values.begin(), value.values.end(),
+					static_cast<long>(iccAtoms.DeleteWindow) ) != value.values.end();
+			break;
+		case NormalHints: {
+			minSize = maxSize = {};
+			if(!longs || value.values.size() < 9) break;
+
+			const long flags = value.values[0];
+			if(flags & PMinSize) {
+				minSize = {static_cast<int>(value.values[5]), static_cast<int>(value.values[6])};
+			}
+			if(flags & PMaxSize) {
+				maxSize = {static_cast<int>(value.values[7]), static_cast<int>(value.values[8])};
+			}
+			break;
+		}
+		case NetState:
+			netState.clear();
+			if(longs && value.type == XA_ATOM) {
+				netState.assign(value.values.begin(), value.values.end() );
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+Properties::Request Properties::request(Kind kind, const NetAtom &netAtoms,
+		const IccAtom &iccAtoms) {
+	switch(kind) {
+		case WindowType:
+			return {netAtoms.WMWindowType, XA_ATOM, 1};
+		case Class:
+			return {XA_WM_CLASS, XA_STRING, maxStringLength};
+		case NetName:
+			return {netAtoms.WMName, AnyPropertyType, maxStringLength};
+		case Name:
+			return {XA_WM_NAME, AnyPropertyType, maxStringLength};
+		case Protocols:
+			return {iccAtoms.WMProtocols, XA_ATOM, maxProtocols};
+		case NormalHints:
+			return {XA_WM_NORMAL_HINTS, XA_WM_SIZE_HINTS, sizeHintsLength};
+		case NetState:
+			return {netAtoms.WMState, XA_ATOM, maxStates};
+		default:
+			return {None, None, 0};
+	}
+}
+
+bool Properties::kind(Atom property, const NetAtom &netAtoms, const IccAtom &iccAtoms,
+		Kind &kind) {
+	for(int k = 0; k < NKinds; k++) {
+		if(request(static_cast<Kind>(k), netAtoms, iccAtoms).property == property) {
+			kind = static_cast<Kind>(k);
+			return true;
+		}
+	}
+	return false;
+}
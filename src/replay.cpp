@@ -0,0 +1,309 @@
+#include "window_manager.hpp"
+#include "log.hpp"
+
+#include <unordered_map>
+#include <cstring>
+#include <thread>
+
+extern "C" {
+	#include <X11/Xlibint.h>
+}
+
+//Xlibint.h leaks these
+#undef min
+#undef max
+
+namespace {
+
+const Vector2 defaultSize = {640, 480};
+
+//The server's own events would duplicate the recorded ones
+Bool dropEvent(Display *display, XEvent *event, xEvent *wire) {
+	return False;
+}
+
+Vector2 position(const Trace::Record &record) {
+	int32_t xy[2] = {};
+	std::memcpy(xy, record.data.data(), std::min(record.data.size(), sizeof(xy) ) );
+	return {xy[0], xy[1]};
+}
+
+//Every field naming a window in the events the wm handles
+size_t windowFields(XEvent &e, Window *fields[3]) {
+	size_t n = 0;
+	auto add = [&](Window &w) { fields[n++] = &w; };
+
+	switch(e.type) {
+		case KeyPress:
+		case KeyRelease:
+			add(e.xkey.window); add(e.xkey.root); add(e.xkey.subwindow);
+			break;
+		case ButtonPress:
+		case ButtonRelease:
+			add(e.xbutton.window); add(e.xbutton.root); add(e.xbutton.subwindow);
+			break;
+		case MotionNotify:
+			add(e.xmotion.window); add(e.xmotion.root); add(e.xmotion.subwindow);
+			break;
+		case EnterNotify:
+		case LeaveNotify:
+			add(e.xcrossing.window); add(e.xcrossing.root); add(e.xcrossing.subwindow);
+			break;
+		case CreateNotify:
+			add(e.xcreatewindow.parent); add(e.xcreatewindow.window);
+			break;
+		case DestroyNotify:
+			add(e.xdestroywindow.event); add(e.xdestroywindow.window);
+			break;
+		case UnmapNotify:
+			add(e.xunmap.event); add(e.xunmap.window);
+			break;
+		case MapNotify:
+			add(e.xmap.event); add(e.xmap.window);
+			break;
+		case MapRequest:
+			add(e.xmaprequest.parent); add(e.xmaprequest.window);
+			break;
+		case ReparentNotify:
+			add(e.xreparent.event); add(e.xreparent.window); add(e.xreparent.parent);
+			break;
+		case ConfigureNotify:
+			add(e.xconfigure.event); add(e.xconfigure.window); add(e.xconfigure.above);
+			break;
+		case ConfigureRequest:
+			add(e.xconfigurerequest.parent); add(e.xconfigurerequest.window);
+			add(e.xconfigurerequest.above);
+			break;
+		default:
+			add(e.xany.window);
+			break;
+	}
+
+	return n;
+}
+
+//Stand-ins for the recorded windows, created on a client connection of
+//their own the first time the trace names them. Only geometry carries over,
+//properties were never recorded, so rules and window types see defaults.
+class StandIns {
+	public:
+		StandIns(Display *display, Window recordedRoot)
+			: _display(display), _root(DefaultRootWindow(display) ),
+			_recordedRoot(recordedRoot) {
+		}
+
+		~StandIns() {
+			XCloseDisplay(_display);
+		}
+
+		//Rewrites e to name stand-ins, creating any it needs
+		void remap(XEvent &e) {
+			const Window destroyed = e.type == DestroyNotify ? e.xdestroywindow.window : None;
+
+			Window *fields[3];
+			const size_t n = windowFields(e, fields);
+			for(size_t i = 0; i < n; i++) {
+				*fields[i] = get(*fields[i], e);
+			}
+
+			//The server may hand out the same id to a later window
+			if(auto it = _windows.find(destroyed); it != _windows.end() ) {
+				_doomed.push_back(it->second);
+				_windows.erase(it);
+			}
+		}
+
+		//Before the wm looks at any of them
+		void sync() {
+			if(!_created) return;
+			XSync(_display, False);
+			_created = false;
+		}
+
+		//Once the wm has seen them go
+		void reap() {
+			for(Window w : _doomed) {
+				XDestroyWindow(_display, w);
+			}
+			if(!_doomed.empty() ) XSync(_display, False);
+			_doomed.clear();
+		}
+
+		void warp(Vector2 position) {
+			XWarpPointer(_display, None, _root, 0, 0, 0, 0, position.x, position.y);
+			XSync(_display, False);
+		}
+
+	private:
+		Window get(Window recorded, const XEvent &e) {
+			if(recorded == None) return None;
+			if(recorded == _recordedRoot) return _root;
+			if(auto it = _windows.find(recorded); it != _windows.end() ) return it->second;
+
+			Vector2 position, size = defaultSize;
+			XSetWindowAttributes attributes = {};
+			if(e.type == CreateNotify && e.xcreatewindow.window == recorded) {
+				position = {e.xcreatewindow.x, e.xcreatewindow.y};
+				size = {e.xcreatewindow.width, e.xcreatewindow.height};
+				attributes.override_redirect = e.xcreatewindow.override_redirect;
+			} else if(e.type == ConfigureRequest && e.xconfigurerequest.window == recorded) {
+				position = {e.xconfigurerequest.x, e.xconfigurerequest.y};
+				if(e.xconfigurerequest.value_mask & CWWidth) size.x = e.xconfigurerequest.width;
+				if(e.xconfigurerequest.value_mask & CWHeight) size.y = e.xconfigurerequest.height;
+			}
+
+			const Window w = XCreateWindow(_display, _root, position.x, position.y,
+					static_cast<unsigned int>(std::max(size.x, 1) ),
+					static_cast<unsigned int>(std::max(size.y, 1) ), 0,
+					CopyFromParent, InputOutput, CopyFromParent, CWOverrideRedirect, &attributes);
+			_windows[recorded] = w;
+			_created = true;
+			return w;
+		}
+
+		std::unordered_map<Window, Window> _windows;	//Recorded to stand-in
+		std::vector<Window> _doomed;	//Destroyed in the trace
+		Display *_display;
+		const Window _root;
+		const Window _recordedRoot;
+		bool _created = false;
+};
+
+}
+
+//Records are played in order. Events are collected until a record that
+//made the wm act comes up, then put back on the queue at once and drained
+//by processEvents(), so handlers that take more events out of the queue
+//find the same ones as when recording. Live events are dropped throughout.
+bool WindowManager::replay(const Trace::File &trace, bool realtime, Trace::Totals &totals) {
+	using Nanoseconds = std::chrono::nanoseconds;
+
+	Display *clients = XOpenDisplay(XDisplayString(_display) );
+	if(!clients) {
+		LogError << "Failed to open a client connection to " << XDisplayString(_display);
+		return false;
+	}
+	StandIns standIns(clients, trace.root);
+
+	if(!start() ) return false;
+
+	for(int type = KeyPress; type < LASTEvent; type++) {
+		if(type != GenericEvent) XESetWireToEvent(_display, type, &dropEvent);
+	}
+	XSync(_display, True);
+
+	//Atoms are the server's own, ask for each recorded one by name
+	std::unordered_map<Atom, Atom> atoms;
+	for(const auto &record : trace.records) {
+		if(record.kind != Trace::AtomName || record.data.size() < sizeof(uint64_t) ) continue;
+		uint64_t atom;
+		std::memcpy(&atom, record.data.data(), sizeof(atom) );
+		atoms[static_cast<Atom>(atom)] = XInternAtom(_display,
+				record.data.c_str() + sizeof(atom), False);
+	}
+	auto atom = [&atoms](Atom &a) {
+		if(auto it = atoms.find(a); it != atoms.end() ) a = it->second;
+	};
+
+	std::vector<XEvent> pending;
+	bool pointerPending = false;	//Due before the handler that queried it
+	Vector2 pointer;
+	size_t framePointer = 0;	//Warped to ahead of its Frame
+	unsigned long serialOffset = 0;	//Replay serial less recorded serial, modulo
+	const auto begin = Clock::now();
+
+	//Times whatever the wm does in between two records
+	auto measure = [&](auto &&work) {
+		const auto from = Clock::now();
+		const unsigned long serial = NextRequest(_display);
+		work();
+		totals.handler += std::chrono::duration_cast<Nanoseconds>(Clock::now() - from);
+		totals.requests += NextRequest(_display) - serial;
+	};
+
+	auto drain = [&]() {
+		if(pointerPending) standIns.warp(pointer);
+		pointerPending = false;
+		if(pending.empty() ) return;
+
+		standIns.sync();
+		for(auto it = pending.rbegin(); it != pending.rend(); it++) {
+			XPutBackEvent(_display, &*it);
+		}
+		pending.clear();
+		measure([this]() { processEvents(); });
+		standIns.reap();
+	};
+
+	const auto roundTrips = _metrics.roundTrips();
+	const auto &records = trace.records;
+	for(size_t i = 0; i < records.size() && _running; i++) {
+		const auto &record = records[i];
+		if(realtime && record.kind != Trace::Received) {
+			std::this_thread::sleep_until(begin + Nanoseconds(record.time) );
+		}
+
+		switch(record.kind) {
+			case Trace::Received: {
+				XEvent e = {};
+				std::memcpy(&e, record.data.data(), std::min(record.data.size(), sizeof(e) ) );
+				e.xany.display = _display;
+				e.xany.serial += serialOffset;
+				standIns.remap(e);
+				if(e.type == PropertyNotify) atom(e.xproperty.atom);
+				if(e.type == ClientMessage) atom(e.xclient.message_type);
+				pending.push_back(e);
+				totals.events++;
+				break;
+			}
+			case Trace::Command:
+				drain();
+				measure([&]() { onIpcRequest(record.data); });
+				totals.commands++;
+				break;
+			case Trace::Frame:
+				drain();
+				//The query it made follows, events read while waiting aside
+				for(size_t j = i + 1; j < records.size(); j++) {
+					if(records[j].kind == Trace::Received) continue;
+					if(records[j].kind == Trace::Pointer) {
+						standIns.warp(position(records[j]) );
+						framePointer = j;
+					}
+					break;
+				}
+				measure([this]() { onDragTimer(); });
+				totals.frames++;
+				break;
+			case Trace::Pointer:
+				//Otherwise a handler still to be drained queried it
+				if(i != framePointer && !pointerPending) {
+					pointer = position(record);
+					pointerPending = true;
+				}
+				break;
+			case Trace::Commit: {
+				drain();
+				measure([this]() { _core.commit(); });
+				totals.batches++;
+				uint64_t serial = 0;
+				std::memcpy(&serial, record.data.data(),
+						std::min(record.data.size(), sizeof(serial) ) );
+				serialOffset = NextRequest(_display) - static_cast<unsigned long>(serial);
+				break;
+			}
+			case Trace::AtomName:
+			case Trace::NKinds:
+				break;
+		}
+	}
+
+	drain();
+	measure([this]() { _core.commit(); });
+	totals.wall = std::chrono::duration_cast<Nanoseconds>(Clock::now() - begin);
+	totals.roundTrips = _metrics.roundTrips() - roundTrips;
+	totals.stats = _metrics.json(_core.clients().size() );
+
+	stop();
+	return true;
+}
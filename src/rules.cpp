@@ -0,0 +1,267 @@
+#include "rules.hpp"
+
+#include <algorithm>
+
+constexpr static std::array<std::string_view, Rules::NFields> fieldNames = {{
+	"class",
+	"instance",
+	"title",
+	"type"
+}};
+
+namespace {
+
+//Splits "key=value" and "key" tokens off a line, values may be "quoted"
+class Tokenizer {
+	public:
+		Tokenizer(std::string_view line) : _line(line) {}
+
+		//False at the end of the line or at a comment
+		bool next(std::string_view &key, std::string_view &value, bool &valid) {
+			skipSpace();
+			valid = true;
+			if(_line.empty() || _line.front() == '#') return false;
+
+			size_t end = 0;
+			while(end < _line.size() && _line[end] != '=' && !space(_line[end]) ) {
+				end++;
+			}
+			key = _line.substr(0, end);
+			value = {};
+			_line.remove_prefix(end);
+
+			if(_line.empty() || _line.front() != '=') return true;
+			_line.remove_prefix(1);
+
+			if(!_line.empty() && _line.front() == '"') {
+				end = _line.find('"', 1);
+				if(end == std::string_view::npos) {
+					valid = false;	//Unterminated quote
+					return true;
+				}
+				value = _line.substr(1, end - 1);
+				_line.remove_prefix(end + 1);
+				return true;
+			}
+
+			end = 0;
+			while(end < _line.size() && !space(_line[end]) ) {
+				end++;
+			}
+			value = _line.substr(0, end);
+			_line.remove_prefix(end);
+			return true;
+		}
+
+	private:
+		static bool space(char c) {
+			return c == ' ' || c == '\t' || c == '\r';
+		}
+
+		void skipSpace() {
+			while(!_line.empty() && space(_line.front() ) ) {
+				_line.remove_prefix(1);
+			}
+		}
+
+		std::string_view _line;
+};
+
+}
+
+void Rules::Actions::merge(const Actions &rhs) {
+	if(rhs.workspace >= 0) workspace = rhs.workspace;
+	zoom |= rhs.zoom;
+	floating |= rhs.floating;
+}
+
+bool Rules::compile(std::string_view text, const WorkspaceLookup &workspace,
+		std::string &error) {
+	Rules compiled;
+
+	for(uint32_t lineNo = 1; !text.empty(); lineNo++) {
+		const size_t eol = std::min(text.find('\n'), text.size() );
+		Tokenizer tokens(text.substr(0, eol) );
+		text.remove_prefix(std::min(eol + 1, text.size() ) );
+
+		auto fail = [&](const std::string &what) {
+			error = "line " + std::to_string(lineNo) + ": " + what;
+			return false;
+		};
+
+		Subject key = {};
+		unsigned fields = 0;
+		Actions actions;
+		bool hasAction = false;
+		std::string_view name, value;
+		bool valid;
+
+		while(tokens.next(name, value, valid) ) {
+			if(!valid) return fail("unterminated quote");
+
+			const auto field = std::find(fieldNames.begin(), fieldNames.end(), name);
+			if(field != fieldNames.end() ) {
+				const size_t i = static_cast<size_t>(field - fieldNames.begin() );
+				if(fields & (1u << i) ) return fail("duplicate " + std::string(name) );
+				key[i] = value;
+				fields |= 1u << i;
+			} else if(name == "workspace") {
+				actions.workspace = workspace(value);
+				if(actions.workspace < 0) {
+					return fail("unknown workspace " + std::string(value) );
+				}
+				hasAction = true;
+			} else if(name == "zoom" && value.empty() ) {
+				actions.zoom = hasAction = true;
+			} else if(name == "float" && value.empty() ) {
+				actions.floating = hasAction = true;
+			} else {
+				return fail("unknown token " + std::string(name) );
+			}
+		}
+
+		if(!fields && !hasAction) continue;	//Blank or comment
+		if(!fields) return fail("rule matches nothing");
+		if(!hasAction) return fail("rule does nothing");
+
+		Entry entry = {};
+		entry.hash = hash(key, fields);
+		entry.fields = fields;
+		entry.order = lineNo;
+		entry.actions = actions;
+		for(size_t i = 0; i < NFields; i++) {
+			entry.offset[i] = static_cast<uint32_t>(compiled._strings.size() );
+			entry.length[i] = static_cast<uint32_t>(key[i].size() );
+			compiled._strings += key[i];
+		}
+		compiled._entries.push_back(entry);
+	}
+
+	//One table per combination of matchers, at most half full
+	for(uint32_t i = 0; i < compiled._entries.size(); i++) {
+		const Entry &entry = compiled._entries[i];
+		auto shape = std::find_if(compiled._shapes.begin(), compiled._shapes.end(),
+				[&](const Shape &s) { return s.fields == entry.fields; });
+		if(shape == compiled._shapes.end() ) {
+			compiled._shapes.push_back({entry.fields, {}});
+		}
+	}
+
+	//Lines with the same key keep their own entry and order, chained from
+	//the first one in the table, so lines in between still sort correctly
+	std::vector<uint32_t> tails(compiled._entries.size() );
+	for(auto &shape : compiled._shapes) {
+		const size_t members = static_cast<size_t>(std::count_if(
+					compiled._entries.begin(), compiled._entries.end(),
+					[&](const Entry &e) { return e.fields == shape.fields; }) );
+		size_t capacity = 4;
+		while(capacity < members * 2) capacity <<= 1;
+		shape.slots.assign(capacity, 0);
+
+		for(uint32_t i = 0; i < compiled._entries.size(); i++) {
+			const Entry &entry = compiled._entries[i];
+			if(entry.fields != shape.fields) continue;
+
+			const Subject key = compiled.subject(entry);
+			size_t slot = entry.hash & (capacity - 1);
+			for(; shape.slots[slot]; slot = (slot + 1) & (capacity - 1) ) {
+				const Entry &head = compiled._entries[shape.slots[slot] - 1];
+				if(head.hash == entry.hash && compiled.equal(head, key) ) break;
+			}
+
+			if(shape.slots[slot]) {
+				const uint32_t head = shape.slots[slot] - 1;
+				compiled._entries[tails[head]].next = i + 1;
+				tails[head] = i;
+			} else {
+				shape.slots[slot] = i + 1;
+				tails[i] = i;
+			}
+		}
+	}
+
+	*this = std::move(compiled);
+	return true;
+}
+
+Rules::Actions Rules::match(const Subject &subject) const {
+	std::array<const Entry*, 1u << NFields> matches;
+	size_t n = 0;
+
+	for(const auto &shape : _shapes) {
+		if(const Entry *entry = find(shape, subject) ) {
+			matches[n++] = entry;
+		}
+	}
+
+	//Later lines win. Every chain is in line order, so merging them takes
+	//the earliest head each time, there are few enough shapes for a scan.
+	Actions actions;
+	for(;;) {
+		size_t first = n;
+		for(size_t i = 0; i < n; i++) {
+			if(matches[i] && (first == n || matches[i]->order < matches[first]->order) ) {
+				first = i;
+			}
+		}
+		if(first == n) break;
+
+		const Entry *entry = matches[first];
+		actions.merge(entry->actions);
+		matches[first] = entry->next ? &_entries[entry->next - 1] : nullptr;
+	}
+	return actions;
+}
+
+size_t Rules::size() const {
+	return _entries.size();
+}
+
+//FNV-1a over the matched fields, each tagged with its index
+uint64_t Rules::hash(const Subject &subject, unsigned fields) {
+	uint64_t h = 0xcbf29ce484222325ull;
+	auto mix = [&h](unsigned char c) {
+		h ^= c;
+		h *= 0x100000001b3ull;
+	};
+
+	for(size_t i = 0; i < NFields; i++) {
+		if(!(fields & (1u << i) ) ) continue;
+		mix(static_cast<unsigned char>(i) );
+		for(char c : subject[i]) {
+			mix(static_cast<unsigned char>(c) );
+		}
+		mix(0xff);
+	}
+
+	return h;
+}
+
+Rules::Subject Rules::subject(const Entry &entry) const {
+	Subject key = {};
+	for(size_t i = 0; i < NFields; i++) {
+		key[i] = std::string_view(_strings.data() + entry.offset[i], entry.length[i]);
+	}
+	return key;
+}
+
+bool Rules::equal(const Entry &entry, const Subject &subject) const {
+	for(size_t i = 0; i < NFields; i++) {
+		if(!(entry.fields & (1u << i) ) ) continue;
+		const std::string_view key(_strings.data() + entry.offset[i], entry.length[i]);
+		if(key != subject[i]) return false;
+	}
+	return true;
+}
+
+const Rules::Entry *Rules::find(const Shape &shape, const Subject &subject) const {
+	const uint64_t h = hash(subject, shape.fields);
+	const size_t mask = shape.slots.size() - 1;
+
+	for(size_t slot = h & mask; shape.slots[slot]; slot = (slot + 1) & mask) {
+		const Entry &entry = _entries[shape.slots[slot] - 1];
+		if(entry.hash == h && equal(entry, subject) ) return &entry;
+	}
+
+	return nullptr;
+}
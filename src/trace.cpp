@@ -0,0 +1,190 @@
+#include "trace.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+extern "C" {
+	#include <X11/Xlibint.h>
+}
+
+//Xlibint.h leaks these
+#undef min
+#undef max
+
+using namespace Trace;
+
+Writer *Writer::_active = nullptr;
+Writer::WireToEvent Writer::_converters[LASTEvent] = {};
+
+bool Trace::load(const std::string &path, File &file, std::string &error) {
+	std::FILE *f = std::fopen(path.c_str(), "rb");
+	if(!f) {
+		error = "cannot open " + path;
+		return false;
+	}
+
+	std::string bytes;
+	char chunk[1 << 16];
+	for(size_t n; (n = std::fread(chunk, 1, sizeof(chunk), f) ) > 0;) {
+		bytes.append(chunk, n);
+	}
+	std::fclose(f);
+
+	uint64_t root;
+	if(bytes.size() < sizeof(magic) + sizeof(root)
+			|| std::memcmp(bytes.data(), magic, sizeof(magic) ) != 0) {
+		error = path + " is not a wm trace";
+		return false;
+	}
+	std::memcpy(&root, bytes.data() + sizeof(magic), sizeof(root) );
+	file.root = static_cast<Window>(root);
+	file.records.clear();
+
+	for(size_t at = sizeof(magic) + sizeof(root); at < bytes.size();) {
+		Header header;
+		if(bytes.size() - at < sizeof(header) ) {
+			error = path + " ends inside a record header";
+			return false;
+		}
+		std::memcpy(&header, bytes.data() + at, sizeof(header) );
+		at += sizeof(header);
+
+		if(bytes.size() - at < header.length || header.kind >= NKinds) {
+			error = path + " has a bad record at byte " + std::to_string(at - sizeof(header) );
+			return false;
+		}
+		file.records.push_back({static_cast<Kind>(header.kind), header.time,
+				bytes.substr(at, header.length)});
+		at += header.length;
+	}
+
+	return true;
+}
+
+std::unique_ptr<Writer> Writer::create(const std::string &path, Display *display) {
+	if(_active) return nullptr;
+
+	std::FILE *file = std::fopen(path.c_str(), "wb");
+	if(!file) return nullptr;
+
+	const uint64_t root = DefaultRootWindow(display);
+	std::fwrite(magic, 1, sizeof(magic), file);
+	std::fwrite(&root, 1, sizeof(root), file);
+
+	return std::unique_ptr<Writer>(new Writer(file, display) );
+}
+
+Writer::Writer(std::FILE *file, Display *display)
+	: _file(file), _display(display), _start(Clock::now() ) {
+	_active = this;
+
+	//Extension and generic events are of no interest to the wm
+	for(int type = KeyPress; type < LASTEvent; type++) {
+		if(type == GenericEvent) continue;
+		_converters[type] = XESetWireToEvent(_display, type, &Writer::onWire);
+	}
+
+	//Serials recorded from here on are relative to this one
+	const uint64_t serial = NextRequest(_display);
+	record(Commit, &serial, sizeof(serial) );
+}
+
+Writer::~Writer() {
+	commit();
+	for(int type = KeyPress; type < LASTEvent; type++) {
+		if(_converters[type]) XESetWireToEvent(_display, type, _converters[type]);
+	}
+	_active = nullptr;
+	std::fclose(_file);
+}
+
+void Writer::command(std::string_view request) {
+	record(Command, request.data(), request.size() );
+}
+
+void Writer::frame() {
+	record(Frame, nullptr, 0);
+}
+
+void Writer::pointer(Vector2 position) {
+	const int32_t xy[2] = {position.x, position.y};
+	record(Pointer, xy, sizeof(xy) );
+}
+
+void Writer::commit() {
+	if(_batch.empty() ) return;
+
+	//Events a property or client message carries an atom of are replayed on
+	//another server, where the atom has to be interned by name again
+	std::string next;
+	if(!_unnamed.empty() ) {
+		std::vector<Atom> atoms;
+		atoms.swap(_unnamed);
+		std::vector<char*> names(atoms.size(), nullptr);
+		const size_t mark = _batch.size();
+		XGetAtomNames(_display, atoms.data(), static_cast<int>(atoms.size() ), names.data() );
+
+		//Whatever arrived while waiting on the names is handled in the next batch
+		next = _batch.substr(mark);
+		_batch.resize(mark);
+
+		for(size_t i = 0; i < atoms.size(); i++) {
+			if(!names[i]) continue;
+			std::string payload(sizeof(uint64_t), '\0');
+			const uint64_t atom = atoms[i];
+			std::memcpy(payload.data(), &atom, sizeof(atom) );
+			payload += names[i];
+			record(AtomName, payload.data(), payload.size() );
+			XFree(names[i]);
+			_named.insert(std::lower_bound(_named.begin(), _named.end(), atoms[i]), atoms[i]);
+		}
+	}
+
+	const uint64_t serial = NextRequest(_display);
+	record(Commit, &serial, sizeof(serial) );
+	std::fwrite(_batch.data(), 1, _batch.size(), _file);
+	std::fflush(_file);
+	_batch = std::move(next);
+}
+
+//Runs with the display locked, so it may only take notes
+Bool Writer::onWire(Display *display, XEvent *event, xEvent *wire) {
+	const int type = wire->u.u.type & 0x7f;
+	if(!_converters[type](display, event, wire) ) return False;
+	if(_active && _active->_display == display) _active->received(*event);
+	return True;
+}
+
+void Writer::record(Kind kind, const void *data, size_t length) {
+	Header header = {};
+	header.time = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+				Clock::now() - _start).count() );
+	header.length = static_cast<uint32_t>(length);
+	header.kind = kind;
+
+	_batch.append(reinterpret_cast<const char*>(&header), sizeof(header) );
+	if(length) _batch.append(static_cast<const char*>(data), length);
+}
+
+void Writer::received(const XEvent &e) {
+	XEvent copy = e;
+	copy.xany.display = nullptr;
+
+	//Most event structs are far smaller than the union
+	const auto bytes = reinterpret_cast<const unsigned char*>(&copy);
+	size_t length = sizeof(copy);
+	while(length > 0 && bytes[length - 1] == 0) length--;
+	record(Received, bytes, length);
+
+	if(e.type == PropertyNotify) {
+		name(e.xproperty.atom);
+	} else if(e.type == ClientMessage) {
+		name(e.xclient.message_type);
+	}
+}
+
+void Writer::name(Atom atom) {
+	if(atom == None || std::binary_search(_named.begin(), _named.end(), atom) ) return;
+	if(std::find(_unnamed.begin(), _unnamed.end(), atom) != _unnamed.end() ) return;
+	_unnamed.push_back(atom);
+}
@@ -1,47 +1,83 @@
-#define LOG_DEBUG 0
-#define LOG_ERROR 1
-
 #include "window_manager.hpp"
 #include "event.hpp"
 #include "log.hpp"
 
-#include <X11/Xutil.h>
 #include <X11/Xatom.h>
 
+#include <csignal>
+
+#include <algorithm>
 #include <iostream>
+#include <fstream>
+#include <iterator>
 #include <cassert>
 #include <cstring>
 #include <string>
 #include <array>
 
-using Clients = WindowManager::Clients;
-
 bool WindowManager::_wmDetected = false;
 
-std::unique_ptr<WindowManager> WindowManager::create() {
+std::unique_ptr<WindowManager> WindowManager::create(const Config &config) {
 	Display *display = XOpenDisplay(nullptr);
 	if(display == nullptr) {
 		LogError << "Failed to open X display " << XDisplayName(nullptr);
 		return nullptr;
 	}
 
-	return std::unique_ptr<WindowManager>(new WindowManager(display) );
+	return std::unique_ptr<WindowManager>(new WindowManager(display, config) );
 }
 
-WindowManager::WindowManager(Display *display) 
-	: _display(display), _root(DefaultRootWindow(_display) ), 
+WindowManager::WindowManager(Display *display, const Config &config) 
+	: _rulesWatch(config.rulesPath),
+	_startup{Clock::now(), {}},
+	_frameInterval(std::chrono::duration_cast<Clock::duration>(
+				std::chrono::seconds(1) ) / config.refreshRate),
+	_startupTimings(config.startupTimings),
+	_rulesPath(config.rulesPath),
+	_tracePath(config.tracePath),
+	_display(display), _root(DefaultRootWindow(_display) ), 
 	_check(XCreateSimpleWindow(_display, _root, 0, 0, 1, 1, 0, 0, 0) ),
-	_focused(nullptr),
-	_netAtoms(_display),
-	_iccAtoms(_display),
-	_otherAtoms(_display) {
+	_screen(XDefaultScreenOfDisplay(_display) ),
+	_backend(_display, _netAtoms, _iccAtoms),
+	_core(_backend, _metrics, _netAtoms, config.hiding, {_screen->width, _screen->height}) {
+	internAtoms(_display, _netAtoms, _iccAtoms, _otherAtoms);
+	_metrics.roundTrip();
+	_startup.lap("atoms");
 }
 
 WindowManager::~WindowManager() {
+	_trace.reset();
 	XCloseDisplay(_display);
 }
 
 void WindowManager::run() {
+	if(!start() ) return;
+
+	LogDebug << "All clear, wm starting\n";
+	/*	Loop	*/
+	while(_running) {
+		//Xlib may have queued events while waiting on replies, so drain
+		//those before sleeping on the connection
+		processEvents();
+		_core.commit();
+		if(_trace) _trace->commit();
+		if(_running) _loop->wait();
+	}
+
+	_trace.reset();
+	stop();
+}
+
+//Everything up to the main loop, false if the wm cannot run
+bool WindowManager::start() {
+	//Before anything is asked of the server, so the trace has every event
+	if(!_tracePath.empty() ) {
+		_trace = Trace::Writer::create(_tracePath, _display);
+		if(!_trace) {
+			LogError << "Failed to open trace " << _tracePath << '\n';
+		}
+	}
+
 	//Set temporary errror handler
 	XSetErrorHandler(&WindowManager::onWmDetected);
 	XSelectInput(
@@ -49,41 +85,26 @@ void WindowManager::run() {
 			_root,
 			SubstructureRedirectMask | SubstructureNotifyMask);
 	XSync(_display, False);	//Flush errors
+	_metrics.roundTrip();
 
 	if(_wmDetected) {
 		LogError << "Detected another window manager on display " 
 			<< XDisplayString(_display);
-		return;
+		return false;
 	}
 
 	//Set regular error handler
 	XSetErrorHandler(&WindowManager::onXError);
+	_startup.lap("detect");
 
-	XGrabServer(_display);
-	Window returnedRoot, returnedParent;
-	Window *topLevel;
+	//Whatever an earlier wm left behind is rebuilt by adopt()
+	XDeleteProperty(_display, _root, _netAtoms.clientList);
+	XDeleteProperty(_display, _root, _netAtoms.clientListStacking);
 
-	unsigned int n_topLevel;
+	_core.createContainers();
 
-	assert(XQueryTree(
-				_display,
-				_root,
-				&returnedRoot,
-				&returnedParent,
-				&topLevel,
-				&n_topLevel));
-
-	LogDebug << "Mapping toplevel windows:\n";
-	for(unsigned int i = 0; i < n_topLevel; i++) {
-		LogDebug << i << " : " << topLevel[i] << '\n';
-		frame(topLevel[i], true);
-	}
-	LogDebug << "Mapped " << n_topLevel << " toplevel windows\n";
-
-	XFree(topLevel);
-	XUngrabServer(_display);
-
-	_screen = XDefaultScreenOfDisplay(_display);
+	adopt();
+	_startup.lap("adopt");
 
 	//Set wm check window
 	XChangeProperty(_display, _check, _netAtoms.WMCheck, XA_WINDOW, 32, PropModeReplace,
@@ -101,42 +122,53 @@ void WindowManager::run() {
 	XChangeProperty(_display, _root, _netAtoms.supported, XA_ATOM, 32, PropModeReplace,
 			reinterpret_cast<const unsigned char*>(&_netAtoms), _netAtoms.size() );
 
-	//Set number of desktops
-	unsigned long data = 4;
+	//Set number of desktops and their names, straight from the workspace graph
+	unsigned long data = static_cast<unsigned long>(Core::nWorkspaces);
 	XChangeProperty(_display, _root, _netAtoms.numberOfDesktops, XA_CARDINAL, 32, 
 			PropModeReplace, reinterpret_cast<unsigned char*>(&data), 1);
 
+	std::string names;
+	for(const auto &name : Workspaces::graph.names) {
+		names += name.view();
+		names += '\0';
+	}
+	XChangeProperty(_display, _root, _netAtoms.desktopNames, _otherAtoms.utf8str, 8,
+			PropModeReplace, reinterpret_cast<const unsigned char*>(names.data() ),
+			static_cast<int>(names.size() ) );
+
 	data = 0;
 	XChangeProperty(_display, _root, _netAtoms.currentDesktop, XA_CARDINAL, 32,
 			PropModeReplace, reinterpret_cast<unsigned char*>(&data), 1);
 
-	//Read class specific behaviour
-	_classMap.insert(std::make_pair("firefox", static_cast<int>(Ws::North) ) );
-	_classMap.insert(std::make_pair("discord", static_cast<int>(Ws::East) ) );
+	_startup.lap("ewmh");
+
+	loadRules();
 
 	//IPC event table
-	std::array<std::function<void(long*)>, static_cast<size_t>(Event::NEvents)>
-		events = {
+	_events = {
 			[&](long *arg) {	//Move Direction
 				LogDebug << "Move Direction " << arg[0] << '\n';
-				if(!_focused) return;
-				auto dir = static_cast<WindowManager::Direction>(arg[0]);
-				moveClient(*_focused, workspaceMap(dir));
+				auto client = _core.focused();
+				if(!client) return;
+				auto dir = static_cast<Core::Direction>(arg[0]);
+				_core.moveClient(*client, _core.workspaceMap(dir));
 			},
 			[&](long *arg) {	//Go Direction
 				LogDebug << "Go Direction " << arg[0] << '\n';
-				auto dir = static_cast<WindowManager::Direction>(arg[0]);
-				switchWorkspace(workspaceMap(dir));
+				auto dir = static_cast<Core::Direction>(arg[0]);
+				_core.switchWorkspace(_core.workspaceMap(dir));
 			},
 			[&](long *arg) {	//Zoom
 				LogDebug << "Zoom\n";
-				if(!_focused) return;
-				zoomClient(*_focused);
+				auto client = _core.focused();
+				if(!client) return;
+				_core.zoomClient(*client);
 			},
 			[&](long *arg) {	//Kill
 				LogDebug << "Kill\n";
-				if(!_focused) return;
-				kill(*_focused);
+				auto client = _core.focused();
+				if(!client) return;
+				kill(*client);
 			},
 			[&](long *arg) {	//Exit
 				LogDebug << "Exit\n";
@@ -144,74 +176,150 @@ void WindowManager::run() {
 			},
 			[&](long *arg) {	//Focus next
 				LogDebug << "Focus next\n";
-				focusNext();
+				_core.focusNext();
 			},
 			[&](long *arg) {	//Focus prev
 				LogDebug << "Focus prev\n";
-				focusPrev();
+				_core.focusPrev();
+			},
+			[&](long *arg) {	//Layout
+				LogDebug << "Layout " << arg[0] << '\n';
+				if(arg[0] < 0 || arg[0] >= Layout::NModes) return;
+				_core.setLayout(_core.currentWorkspace(), static_cast<Layout::Mode>(arg[0]) );
 			}
 		};
 
-	LogDebug << "All clear, wm starting\n";
-	/*	Loop	*/
-	while(_running) {
+	_loop = EventLoop::create();
+	if(!_loop) {
+		LogError << "Failed to create event loop\n";
+		return false;
+	}
+
+	_loop->watch(ConnectionNumber(_display), [this]() {
+		processEvents();
+	});
+
+	_loop->watch(_dragTimer.fd(), [this]() {
+		_dragTimer.acknowledge();
+		if(_trace) _trace->frame();
+		onDragTimer();
+	});
+
+	_loop->watch(_signals.fd(), [this]() {
+		onSignal();
+	});
+
+	if(_rulesWatch.fd() >= 0) {
+		_loop->watch(_rulesWatch.fd(), [this]() {
+			if(_rulesWatch.changed() ) loadRules();
+		});
+	}
+
+	_ipc = IpcServer::create(Ipc::socketPath(), *_loop, [this](std::string_view request) {
+		if(_trace) _trace->command(request);
+		return onIpcRequest(request);
+	});
+	if(!_ipc) {
+		LogError << "Failed to create IPC socket " << Ipc::socketPath() 
+			<< ", only WM_REQUEST client messages are served\n";
+	}
+
+	_startup.lap("ipc");
+
+	if(_startupTimings) {
+		_startup.print();
+	}
+
+	return true;
+}
+
+void WindowManager::stop() {
+	_core.release();
+	XDeleteProperty(_display, _root, _netAtoms.clientList);
+	XDeleteProperty(_display, _root, _netAtoms.clientListStacking);
+
+	_ipc.reset();
+}
+
+void WindowManager::processEvents() {
+	//Every queued event is handled in one go, XPending also flushes
+	while(_running && XPending(_display) > 0) {
 		XEvent e;
 		XNextEvent(_display, &e);
 
+		const auto start = Metrics::Clock::now();
+		const auto roundTrips = _metrics.roundTrips();
+		handleEvent(e);
+		_metrics.event(e.type, Metrics::Clock::now() - start, 
+				_metrics.roundTrips() - roundTrips);
+	}
+}
+
+void WindowManager::handleEvent(XEvent &e) {
+	//Walks every client, so only when it is going to be written out
+	if(Logger::enabled(Logger::Debug) ) {
 		LogDebug << "Clients:\n";
-		for(const auto &c : _clients) {
+		for(const auto &c : _core.clients() ) {
 			LogDebug << '\t' << c.window << '\n';
 		}
-		LogDebug << "Total clients: " << _clients.size() << '\n';
-
-		switch(e.type) {
-			case ConfigureRequest:
-				onConfigureRequest(e.xconfigurerequest);
-				break;
-			case MapRequest:
-				onMapRequest(e.xmaprequest);
-				break;
-			case UnmapNotify:
-				onUnmapNotify(e.xunmap);
-				break;
-			case ButtonPress:
-				onButtonPress(e.xbutton);
-				break;
-			case FocusIn:
-				onFocusIn(e.xfocus);
-				break;
-			case EnterNotify:
-				onEnterNotify(e.xcrossing);
-				break;
-			case MotionNotify:
-				//Waste all MotionNotify events but the latest
-				while(XCheckTypedWindowEvent(
-							_display,
-							e.xmotion.window,
-							MotionNotify,
-							&e));
-
-				onMotionNotify(e.xmotion);
-				break;
-			case ClientMessage:
-				if(e.xclient.message_type == XInternAtom(_display, Event::RequestAtom, False) ) {
-					LogDebug << "Client message: " << e.xclient.data.l[0] << '\n';
-					events[e.xclient.data.l[0]](&e.xclient.data.l[1]);
-				}
-				break;
-			case KeyPress:
-			case CreateNotify:
-			case DestroyNotify:
-			case ReparentNotify:
-			case ConfigureNotify:
-			case MapNotify:
-			default:
-				break;
-		}
+		LogDebug << "Total clients: " << _core.clients().size() << '\n';
 	}
 
-	for(const auto &c : _clients) {
-		unframe(c);
+	switch(e.type) {
+		case ConfigureRequest:
+			coalesceConfigure(e.xconfigurerequest);
+			onConfigureRequest(e.xconfigurerequest);
+			break;
+		case ConfigureNotify:
+			onConfigureNotify(e.xconfigure);
+			break;
+		case MapRequest:
+			onMapRequest(e.xmaprequest);
+			break;
+		case UnmapNotify:
+			onUnmapNotify(e.xunmap);
+			break;
+		case ButtonPress:
+			onButtonPress(e.xbutton);
+			break;
+		case ButtonRelease:
+			onButtonRelease(e.xbutton);
+			break;
+		case FocusIn:
+			onFocusIn(e.xfocus);
+			break;
+		case EnterNotify:
+			onEnterNotify(e.xcrossing);
+			break;
+		case PropertyNotify:
+			onPropertyNotify(e.xproperty);
+			break;
+		case MotionNotify:
+			//Waste all MotionNotify events but the latest
+			while(XCheckTypedWindowEvent(
+						_display,
+						e.xmotion.window,
+						MotionNotify,
+						&e));
+
+			onMotionNotify(e.xmotion);
+			break;
+		case ClientMessage:
+			if(e.xclient.message_type == _otherAtoms.wmRequest
+					&& e.xclient.data.l[0] >= 0 && e.xclient.data.l[0] < Event::NEvents) {
+				LogDebug << "Client message: " << e.xclient.data.l[0] << '\n';
+				_events[e.xclient.data.l[0]](&e.xclient.data.l[1]);
+			}
+			break;
+		case DestroyNotify:
+			onDestroyNotify(e.xdestroywindow);
+			break;
+		case KeyPress:
+		case CreateNotify:
+		case ReparentNotify:
+		case MapNotify:
+		default:
+			break;
 	}
 }
 
@@ -232,67 +340,226 @@ int WindowManager::onWmDetected(Display *display, XErrorEvent *e) {
 }
 
 void WindowManager::onConfigureRequest(const XConfigureRequestEvent &e) {
+	constexpr unsigned long geometryMask = CWX | CWY | CWWidth | CWHeight;
 	XWindowChanges changes;
 
 	changes.x = e.x;
 	changes.y = e.y;
 	changes.width = e.width;
 	changes.height = e.height;
+	changes.border_width = e.border_width;
 	changes.sibling = e.above;
 	changes.stack_mode = e.detail;
 
-	if(auto client = find(e.window); client != _clients.end() ) {
-		client->size = Vector2{e.width, e.height};
-		client->position = Vector2{e.x, e.y};
-		XConfigureWindow(_display, e.window, e.value_mask, &changes);
-		LogDebug << "Resize " << e.window << " to w:" 
-			<< e.width << " h:" << e.height << '\n';
+	auto client = _core.find(e.window);
+	if(!client) {
+		//Not ours to judge, typically a window setting itself up before mapping
+		XConfigureWindow(_display, e.window, static_cast<unsigned int>(e.value_mask), 
+				&changes);
+		_metrics.configureRequest(Metrics::Forwarded);
+		return;
+	}
+
+	Layout::Geometry requested = {client->position, client->size};
+	if(e.value_mask & CWX) requested.position.x = e.x;
+	if(e.value_mask & CWY) requested.position.y = e.y;
+	if(e.value_mask & CWWidth) requested.size.x = e.width;
+	if(e.value_mask & CWHeight) requested.size.y = e.height;
+
+	const Layout::Geometry allowed = _core.allowed(*client, requested);
+
+	unsigned long mask = e.value_mask & ~geometryMask;
+	if(allowed.position.x != client->position.x) mask |= CWX;
+	if(allowed.position.y != client->position.y) mask |= CWY;
+	if(allowed.size.x != client->size.x) mask |= CWWidth;
+	if(allowed.size.y != client->size.y) mask |= CWHeight;
+
+	const bool rewritten = allowed.position.x != requested.position.x 
+		|| allowed.position.y != requested.position.y
+		|| allowed.size.x != requested.size.x 
+		|| allowed.size.y != requested.size.y;
+
+	client->position = allowed.position;
+	client->size = allowed.size;
+	client->notify = true;
+	_core.markDirty(*client);	//Geometry goes out with the batch, hidden offset included
+
+	//Border width and stacking are passed on as they are
+	if(const unsigned long rest = mask & ~geometryMask) {
+		XConfigureWindow(_display, e.window, static_cast<unsigned int>(rest), &changes);
+	}
+	if(mask & CWStackMode) {
+		_core.restack(e.window, e.detail, mask & CWSibling ? e.above : None);
+	}
+
+	_metrics.configureRequest(!mask ? Metrics::Suppressed 
+			: rewritten ? Metrics::Rewritten : Metrics::Forwarded);
+	LogDebug << "ConfigureRequest " << e.window << " to " << allowed.position.x << ','
+		<< allowed.position.y << ' ' << allowed.size.x << 'x' << allowed.size.y 
+		<< (mask ? "\n" : " suppressed\n");
+}
+
+void WindowManager::coalesceConfigure(XConfigureRequestEvent &e) {
+	//Scan state, the predicate runs once per queued event in queue order
+	struct Scan {
+		Window window;
+		bool blocked;
+	} scan = {e.window, false};
+
+	auto predicate = [](Display*, XEvent *ev, XPointer arg) -> Bool {
+		auto s = reinterpret_cast<Scan*>(arg);
+		if(s->blocked) return False;
+
+		switch(ev->type) {
+			case ConfigureRequest:
+				if(ev->xconfigurerequest.window == s->window) return True;
+				//Restacking another window orders it against ours
+				s->blocked = ev->xconfigurerequest.value_mask & CWStackMode;
+				break;
+			case MapRequest:
+				s->blocked = ev->xmaprequest.window == s->window;
+				break;
+			case UnmapNotify:
+				s->blocked = ev->xunmap.window == s->window;
+				break;
+			case DestroyNotify:
+				s->blocked = ev->xdestroywindow.window == s->window;
+				break;
+		}
+		return False;
+	};
+
+	XEvent next;
+	while(XCheckIfEvent(_display, &next, predicate, reinterpret_cast<XPointer>(&scan) ) ) {
+		const XConfigureRequestEvent &later = next.xconfigurerequest;
+
+		if(later.value_mask & CWX) e.x = later.x;
+		if(later.value_mask & CWY) e.y = later.y;
+		if(later.value_mask & CWWidth) e.width = later.width;
+		if(later.value_mask & CWHeight) e.height = later.height;
+		if(later.value_mask & CWBorderWidth) e.border_width = later.border_width;
+
+		//The last restack wins whole, a sibling only counts with its own mode
+		if(later.value_mask & CWStackMode) {
+			e.value_mask &= ~static_cast<unsigned long>(CWSibling);
+			e.detail = later.detail;
+			e.above = later.above;
+		}
 
+		e.value_mask |= later.value_mask;
+		_metrics.configureRequest(Metrics::Coalesced);
+	}
+}
+
+void WindowManager::onConfigureNotify(const XConfigureEvent &e) {
+	if(auto client = _core.find(e.window) ) {
+		_core.configured(*client, {e.x, e.y}, {e.width, e.height}, e.serial);
 	}
 }
 
 void WindowManager::onMapRequest(const XMapRequestEvent &e) {
-	LogDebug << "Attempting to map " << e.window << '\n';
-	bool framed = frame(e.window, false);
-	XMapWindow(_display, e.window);
-	if(framed) {
-		focus(*find(e.window) );
+	WindowQuery query(_display, _netAtoms, _iccAtoms);
+	std::vector<Window> remapped;
+	auto request = [&](Window w) {
+		//A client asking again is an iconified one to be shown, by itself
+		//or by a pager, and keeps the input selected when it was framed
+		if(_core.find(w) ) {
+			remapped.push_back(w);
+			return;
+		}
+
+		//Property changes are watched from before the query is sent, any
+		//made after its reply arrive as PropertyNotify instead of being lost
+		XSelectInput(_display, w, PropertyChangeMask);
+		query.add(w);
+	};
+	request(e.window);
+
+	//Pipeline every MapRequest queued right behind this one into the same batch
+	XEvent next;
+	while(XEventsQueued(_display, QueuedAlready) > 0) {
+		XPeekEvent(_display, &next);
+		if(next.type != MapRequest) break;
+		XNextEvent(_display, &next);
+		request(next.xmaprequest.window);
+	}
+
+	query.collect();
+
+	std::vector<Window> windows;
+	std::vector<Window> framed;
+	windows.reserve(query.infos().size() );
+	for(const auto &info : query.infos() ) {
+		LogDebug << "Attempting to map " << info.window << '\n';
+		if(frame(info, false) ) {
+			framed.push_back(info.window);
+		}
+		windows.push_back(info.window);
+	}
+
+	_core.map(windows, framed);
+
+	_metrics.roundTrip(query.roundTrips() );
+	_metrics.framed(framed.size(), query.roundTrips() );
+	LogDebug << "Framed " << query.infos().size() << " window(s) in " 
+		<< query.roundTrips() << " round-trip(s)\n";
+
+	if(!framed.empty() ) {
+		_core.focus(*_core.find(framed.back() ) );
+	}
+
+	for(Window w : remapped) {
+		if(auto client = _core.find(w) ) _core.activate(*client);
 	}
 }
 
 void WindowManager::onUnmapNotify(const XUnmapEvent &e) {
-	auto client = find(e.window);
-	if(client == _clients.end() ) {
+	auto client = _core.find(e.window);
+	if(!client) {
 		LogDebug << "Ignore UnmapNotify for non-client window " << e.window << '\n';
 		return;
 	}
 
-	unframe(*client);
+	//A synthetic UnmapNotify is the client withdrawing, even while iconic
+	if(!e.send_event && client->ignoreUnmaps > 0) {
+		client->ignoreUnmaps--;
+		return;
+	}
+
+	_core.unmanage(*client);
+}
+
+//Only reaches clients that were unmapped already, iconified ones hidden
+//on another workspace, every other client was unmanaged on its UnmapNotify
+void WindowManager::onDestroyNotify(const XDestroyWindowEvent &e) {
+	if(auto client = _core.find(e.window) ) {
+		LogDebug << "Client " << e.window << " destroyed while unmapped\n";
+		_core.unmanage(*client);
+	}
 }
 
 void WindowManager::onButtonPress(const XButtonEvent &e) {
-	auto client = find(e.window);
+	auto client = _core.find(e.window);
 	LogDebug << "Click in window " << e.window << '\n';
+	if(!client || client->fullscreen) return;
+
+	_drag.client = client->handle;
+	_drag.button = e.button;
+	_drag.pending = false;
+	_drag.startCursorPos = {e.x_root, e.y_root};
+	_drag.startWindowPos = client->position;
+	_drag.startWindowSize = client->size;
+	_drag.lastFrame = Clock::now();
+}
 
-	startCursorPos = {e.x_root, e.y_root};
-
-	Window returned;
-	Vector2 pos;
-	unsigned int w, h, border, depth;
+void WindowManager::onButtonRelease(const XButtonEvent &e) {
+	if(e.button != _drag.button) return;
 
-	XGetGeometry(
-			_display,
-			client->window,
-			&returned,
-			&pos.x, &pos.y,
-			&w, &h,
-			&border,
-			&depth);
-
-	startWindowPos = pos;
-	startWindowSize = {
-		static_cast<int>(w), 
-		static_cast<int>(h)};
+	//Land exactly where the pointer was let go, whatever the pacing skipped
+	applyDrag({e.x_root, e.y_root});
+	_drag.button = 0;
+	_drag.pending = false;
+	_dragTimer.disarm();
 }
 
 void WindowManager::onFocusIn(const XFocusChangeEvent &e) {
@@ -301,156 +568,222 @@ void WindowManager::onFocusIn(const XFocusChangeEvent &e) {
 
 void WindowManager::onEnterNotify(const XEnterWindowEvent &e) {
 	LogDebug << "Entered window " << e.window << '\n';
-	if(_focused && _focused->fullscreen) {
+
+	if(_core.caused(e.serial) ) {
+		_metrics.enterNotify(Metrics::Caused);
+		return;
+	}
+	if(e.mode != NotifyNormal) {
+		_metrics.enterNotify(Metrics::Grab);
+		return;
+	}
+	if(e.detail == NotifyInferior) {
+		_metrics.enterNotify(Metrics::Inferior);
 		return;
 	}
-	focus(*find(e.window));
-}
 
-void WindowManager::onMotionNotify(const XMotionEvent &e) {
-	const Vector2 cursorPos = {e.x_root, e.y_root};
-	auto client = find(e.window);
+	auto focused = _core.focused();
+	if(focused && focused->fullscreen) {
+		return;
+	}
 
-	if(client->fullscreen) return;
+	auto client = _core.find(e.window);
+	if(!client) return;
+	_metrics.enterNotify(Metrics::Followed);
+	if(client != focused) _core.focus(*client);
+}
 
-	if(e.state & Button1Mask) {	//Move window
-		const Vector2 delta = cursorPos - startCursorPos;
-		const Vector2 newPos = startWindowPos + delta;
-		client->position = Vector2(newPos.x, newPos.y);
-		XMoveWindow(
-				_display,
-				client->window,
-				newPos.x,
-				newPos.y);
+void WindowManager::onPropertyNotify(const XPropertyEvent &e) {
+	Properties::Kind kind;
+	if(!Properties::kind(e.atom, _netAtoms, _iccAtoms, kind) ) return;
+	if(kind == Properties::NetState) return;	//Written by wm itself
 
-	} else if(e.state & Button3Mask) { //Resize window
-		constexpr int minWinSize = 64;
-		const Vector2 delta = cursorPos - startCursorPos;
-		const Vector2 newSize = {
-			std::max(startWindowSize.x + delta.x, minWinSize),
-			std::max(startWindowSize.y + delta.y, minWinSize)};
+	auto client = _core.find(e.window);
+	if(!client) return;
 
-		//One for the window
-		XResizeWindow(
-				_display,
-				e.window,
-				newSize.x, newSize.y);
+	LogDebug << "Property " << static_cast<int>(kind) << " of window " << e.window << " changed\n";
+	client->properties.stale |= 1u << kind;
+}
+
+//Reads whatever changed since it was cached, in Kind order
+Properties &WindowManager::properties(Client &client) {
+	Properties &properties = client.properties;
+	for(int kind = 0; properties.stale; kind++) {
+		const unsigned bit = 1u << kind;
+		if(!(properties.stale & bit) ) continue;
+		properties.stale &= ~bit;
+		readProperty(client, static_cast<Properties::Kind>(kind) );
+
+		//Without _NET_WM_NAME the title falls back to WM_NAME, which is not cached
+		if(kind == Properties::NetName && !properties.netName) {
+			properties.stale |= 1u << Properties::Name;
+		}
 	}
+	return properties;
 }
 
-void WindowManager::focus(Client &client) {
-	XDeleteProperty(_display, _root, _netAtoms.activeWindow);
-	LogDebug << "Deleting activeWindow property\n";
-	_focused = &client;
-	XChangeProperty(_display, _root, _netAtoms.activeWindow, XA_WINDOW, 32, PropModeReplace,
-			reinterpret_cast<unsigned char*>(&client.window), 1);
-	LogDebug << "Changing activeWindow property\n";
-	XRaiseWindow(_display, client.window);
-	XSetInputFocus(_display, client.window, RevertToParent, CurrentTime);
+void WindowManager::readProperty(Client &client, Properties::Kind kind) {
+	const auto request = Properties::request(kind, _netAtoms, _iccAtoms);
+	PropertyValue value;
+	unsigned long nItems, bytesAfter;
+	unsigned char *data = nullptr;
+
+	_metrics.roundTrip();
+	if(XGetWindowProperty(_display, client.window, request.property, 0, request.length,
+				False, request.type, &value.type, &value.format, &nItems, &bytesAfter,
+				&data) != Success) {
+		value = {};
+	} else if(value.format == 8) {
+		value.bytes.assign(reinterpret_cast<char*>(data), nItems);
+	} else if(value.format == 32) {
+		const long *longs = reinterpret_cast<long*>(data);
+		value.values.assign(longs, longs + nItems);
+	}
+
+	if(data) XFree(data);
+	client.properties.set(kind, value, _iccAtoms);
 }
 
-void WindowManager::focusLast() {
-	for(auto it = _clients.rbegin(); it != _clients.rend(); it++) {
-		if(it->workspace == _currentWorkspace) {
-			focus(*it);
-			return;
-		}
+void WindowManager::onMotionNotify(const XMotionEvent &e) {
+	if(!_drag.button) return;
+
+	//Motion is only a hint, the pointer is queried once the frame is due
+	_drag.pending = true;
+	const auto remaining = _drag.lastFrame + _frameInterval - Clock::now();
+	if(remaining <= Clock::duration::zero() ) {
+		onDragTimer();
+	} else if(!_dragTimer.armed() ) {
+		_dragTimer.arm(remaining);
 	}
+}
+
+void WindowManager::onDragTimer() {
+	if(!_drag.pending) return;
+
+	Window returnedRoot, returnedChild;
+	Vector2 cursorPos, windowPos;
+	unsigned int mask;
 
-	_focused = nullptr;
-	XDeleteProperty(_display, _root, _netAtoms.activeWindow);
-	XSetInputFocus(_display, _root, RevertToPointerRoot, CurrentTime);
+	//Also re-arms PointerMotionHintMask for the next MotionNotify
+	XQueryPointer(
+			_display,
+			_root,
+			&returnedRoot,
+			&returnedChild,
+			&cursorPos.x, &cursorPos.y,
+			&windowPos.x, &windowPos.y,
+			&mask);
+	_metrics.roundTrip();
+	if(_trace) _trace->pointer(cursorPos);
+
+	applyDrag(cursorPos);
 }
 
-void WindowManager::focusNext() {
-	if(!_focused) return;
+std::string WindowManager::onIpcRequest(std::string_view request) {
+	LogDebug << "IPC request: " << request << '\n';
 
-	int diff = _focused - &*_clients.begin();
-	for(auto it = _clients.begin() + diff + 1; true; it++) {
-		if(it >= _clients.end() ) it = _clients.begin();
-		if(it->workspace == _currentWorkspace) {
-			focus(*it);
-			return;
-		}
+	std::vector<std::string_view> words;
+	while(!request.empty() ) {
+		const size_t end = std::min(request.find(' '), request.size() );
+		if(end > 0) words.push_back(request.substr(0, end) );
+		request.remove_prefix(std::min(end + 1, request.size() ) );
 	}
-}
 
-void WindowManager::focusPrev() {
-	if(!_focused) return;
+	if(words.empty() ) return "error empty request\n";
 
-	int diff = _focused - &*_clients.begin();
-	for(auto it = _clients.begin() + diff - 1; true ; it--) {
-		if(it < _clients.begin() ) it = _clients.end() - 1;
-		if(it->workspace == _currentWorkspace) {
-			focus(*it);
-			return;
+	const auto start = Metrics::Clock::now();
+	const auto roundTrips = _metrics.roundTrips();
+
+	if(const long type = Event::option(words[0]); type >= 0) {
+		if(static_cast<size_t>(Event::options[type].args) != words.size() - 1) {
+			return "error parameter count mismatch\n";
 		}
+
+		std::array<long, 4> args = {};
+		for(size_t i = 1; i < words.size(); i++) {
+			args[i - 1] = Event::argument(type, words[i]);
+			if(args[i - 1] == -1l) return "error invalid argument\n";
+		}
+
+		_events[type](args.data() );
+		_metrics.command(type, Metrics::Clock::now() - start, 
+				_metrics.roundTrips() - roundTrips);
+		return "ok\n";
+	}
+
+	const long type = Event::query(words[0]);
+	if(type < 0) return "error unknown request\n";
+
+	std::string reply = "ok\n";
+	switch(type) {
+		case Event::Focused:
+			if(auto client = _core.focused() ) {
+				reply += std::to_string(client->window) + '\n';
+			}
+			break;
+		case Event::ClientList:
+			//window workspace x y width height
+			for(const auto &client : _core.clients() ) {
+				reply += std::to_string(client.window) + ' ' 
+					+ std::to_string(client.workspace) + ' '
+					+ std::to_string(client.position.x) + ' ' 
+					+ std::to_string(client.position.y) + ' '
+					+ std::to_string(client.size.x) + ' ' 
+					+ std::to_string(client.size.y) + '\n';
+			}
+			break;
+		case Event::CurrentWorkspace:
+			reply += std::to_string(_core.currentWorkspace() ) + '\n';
+			break;
+		case Event::Stats:
+			reply += _metrics.json(_core.clients().size() );
+			break;
 	}
 
+	_metrics.query(type, Metrics::Clock::now() - start, 
+			_metrics.roundTrips() - roundTrips);
+	return reply;
 }
 
-bool WindowManager::frame(Window w, bool createdBefore) {
+bool WindowManager::frame(const WindowInfo &info, bool createdBefore) {
+	const Window w = info.window;
 
-	XWindowAttributes attrs;
-	assert(XGetWindowAttributes(_display, w, &attrs) );
+	if(!info.valid() ) {
+		LogDebug << "Window " << w << " vanished before it could be framed\n";
+		return false;
+	}
 
 	if(createdBefore) {
-		if(attrs.override_redirect || attrs.map_state != IsViewable) {
+		if(info.overrideRedirect || info.mapState != IsViewable) {
 			LogDebug << "Window " << w << " not managed\n";
 			return false;
 		}
 	}
 
-	Atom* prop = getWindowProperty(w);
-
-	if(prop) {
-		LogDebug << "Window " << w << " is _NET_WM_WINDOW_DOCK: " << std::boolalpha <<
-			(*prop == _netAtoms.WMWindowDock) << '\n';
-		LogDebug << "Window " << w << " is _NET_WM_WINDOW_TOOLBAR: " << std::boolalpha <<
-			(*prop == _netAtoms.WMWindowToolbar) << '\n';
-		LogDebug << "Window " << w << " is _NET_WM_WINDOW_UTILITY: " << std::boolalpha <<
-			(*prop == _netAtoms.WMWindowUtility) << '\n';
-		LogDebug << "Window " << w << " is _NET_WM_WINDOW_MENU: " << std::boolalpha <<
-			(*prop == _netAtoms.WMWindowMenu) << '\n';
-
-		if(*prop == _netAtoms.WMWindowDock) {
-				registerDock(w);
+	if(const Atom type = info.properties.windowType; type != None) {
+		LogDebug << "Window " << w << " is _NET_WM_WINDOW_DOCK: " <<
+			(type == _netAtoms.WMWindowDock) << '\n';
+		LogDebug << "Window " << w << " is _NET_WM_WINDOW_TOOLBAR: " <<
+			(type == _netAtoms.WMWindowToolbar) << '\n';
+		LogDebug << "Window " << w << " is _NET_WM_WINDOW_UTILITY: " <<
+			(type == _netAtoms.WMWindowUtility) << '\n';
+		LogDebug << "Window " << w << " is _NET_WM_WINDOW_MENU: " <<
+			(type == _netAtoms.WMWindowMenu) << '\n';
+
+		if(type == _netAtoms.WMWindowDock) {
+				_core.dock(info.position, info.size);
 		}
 
-		if(*prop == _netAtoms.WMWindowDock ||
-				*prop == _netAtoms.WMWindowToolbar ||
-				*prop == _netAtoms.WMWindowUtility ||
-				*prop == _netAtoms.WMWindowMenu) {
+		if(type == _netAtoms.WMWindowDock ||
+				type == _netAtoms.WMWindowToolbar ||
+				type == _netAtoms.WMWindowUtility ||
+				type == _netAtoms.WMWindowMenu) {
 			LogDebug << "Window " << w << " not managed\n";
-			XFree(prop);
+			XSelectInput(_display, w, NoEventMask);	//Watched since its MapRequest
 			return false;	//Do not manage the window
 		}
-
-		XFree(prop);	//Only free what is not nullptr
 	} 
 
-	if(attrs.y < _upperBorder) {
-		attrs.y = _upperBorder;
-	}
-
-	if(const int dy = attrs.height + _lowerBorder + attrs.y - _screen->height; 
-			dy > 0) {
-		attrs.height -= dy;
-	}
-
-	XMoveWindow(
-		_display,
-		w,
-		attrs.x,
-		attrs.y);
-
-	XResizeWindow(
-		_display, 
-		w, 
-		attrs.width, 
-		attrs.height);
-
-
 	XSelectInput(
 			_display,
 			w,
@@ -459,26 +792,20 @@ bool WindowManager::frame(Window w, bool createdBefore) {
 	XSelectInput(
 			_display,
 			w,
-			EnterWindowMask);
-
-	_clients.push_back({
-		w, 
-		_currentWorkspace,
-		{attrs.x, attrs.y},
-		{attrs.width, attrs.height},
-		{attrs.x, attrs.y},
-		false
-	});
-	
-	XClassHint hint;
-	XGetClassHint(_display, w, &hint);
+			EnterWindowMask | PropertyChangeMask);
 
-	if(auto it = _classMap.find(hint.res_class); it != _classMap.end() ) {
-		moveClient(_clients.back(), it->second);
-	}
+	Client managed;
+	managed.window = w;
+	managed.size = info.size;
+	managed.position = info.position;
+	managed.sentPosition = info.position;
+	managed.sentSize = info.size;
+	managed.properties = info.properties;
+	managed.mapped = createdBefore;
 
-	XFree(hint.res_class);
-	XFree(hint.res_name);
+	const Properties &properties = info.properties;
+	_core.manage(managed, _rules.match({properties.resClass,
+			properties.resName, properties.title, typeName(properties.windowType)}) );
 
 	//Grab Alt + LMB
 	XGrabButton(
@@ -487,7 +814,7 @@ bool WindowManager::frame(Window w, bool createdBefore) {
 			modifierMask,
 			w,
 			False,
-			ButtonPressMask | ButtonMotionMask,
+			ButtonPressMask | ButtonReleaseMask | ButtonMotionMask | PointerMotionHintMask,
 			GrabModeAsync,
 			GrabModeAsync,
 			None,
@@ -500,7 +827,7 @@ bool WindowManager::frame(Window w, bool createdBefore) {
 			modifierMask,
 			w,
 			False,
-			ButtonPressMask | ButtonMotionMask,
+			ButtonPressMask | ButtonReleaseMask | ButtonMotionMask | PointerMotionHintMask,
 			GrabModeAsync,
 			GrabModeAsync,
 			None,
@@ -510,58 +837,57 @@ bool WindowManager::frame(Window w, bool createdBefore) {
 	return true;
 }
 
-void WindowManager::unframe(const Client &client) {
-	erase(client.window);
-	focusLast();
-	LogDebug << "Unframed Window: " << client.window << '\n';
-}
+void WindowManager::adopt() {
+	//Nothing can change under us while the existing windows are taken over,
+	//so the grab only lasts for the tree query and one batch of replies
+	XGrabServer(_display);
+	Window returnedRoot, returnedParent;
+	Window *topLevel = nullptr;
+	unsigned int n_topLevel = 0;
 
-void WindowManager::switchWorkspace(int workspace) {
-	for(auto &client : _clients) {
-		if(client.workspace == _currentWorkspace) {
-			hide(client);
-		}
+	if(!XQueryTree(
+				_display,
+				_root,
+				&returnedRoot,
+				&returnedParent,
+				&topLevel,
+				&n_topLevel) ) {
+		LogError << "Failed to query toplevel windows\n";
+		XUngrabServer(_display);
+		return;
 	}
 
-	_currentWorkspace = workspace;
-
-	for(auto &client : _clients) {
-		if(client.workspace == _currentWorkspace) {
-			show(client);
-		}
+	//The server is grabbed, nothing can change before frame() selects input
+	WindowQuery query(_display, _netAtoms, _iccAtoms);
+	LogDebug << "Mapping toplevel windows:\n";
+	for(unsigned int i = 0; i < n_topLevel; i++) {
+		LogDebug << i << " : " << topLevel[i] << '\n';
+		query.add(topLevel[i]);
 	}
-	
-	unsigned long data = static_cast<unsigned long>(workspace);
-	XChangeProperty(_display, _root, _netAtoms.currentDesktop, XA_CARDINAL, 32,
-			PropModeReplace, reinterpret_cast<unsigned char*>(&data), 1);
+	XFree(topLevel);
 
-	focusLast();
-	printLayout();
-}
+	query.collect();
 
-void WindowManager::hide(Client &client) {
-	XWindowAttributes xattr;
-	XGetWindowAttributes(_display, client.window, &xattr);
+	unsigned long framed = 0;
+	for(const auto &info : query.infos() ) {
+		framed += frame(info, true);
+	}
 
-	client.restore = {xattr.x, xattr.y};
+	XUngrabServer(_display);
 
-	//Big brain window hide
-	XMoveWindow(
-		_display,
-		client.window,
-		xattr.x + _screen->width,
-		xattr.y + _screen->height);
+	_metrics.roundTrip(query.roundTrips() + 1);	//XQueryTree included
+	_metrics.framed(framed, query.roundTrips() + 1);
+	LogDebug << "Mapped " << n_topLevel << " toplevel windows\n";
 }
 
-void WindowManager::show(const Client &client) {
-	XMoveWindow(
-		_display,
-		client.window,
-		client.restore.x,
-		client.restore.y);
-}
+void WindowManager::kill(Client &client) {
+	//Clients that do not take part in WM_DELETE_WINDOW would ignore it
+	if(!properties(client).deleteWindow) {
+		XKillClient(_display, client.window);
+		_core.focusLast();
+		return;
+	}
 
-void WindowManager::kill(const Client &client) {
 	XEvent ev;
     ev.type = ClientMessage;
     ev.xclient.window = client.window;
@@ -570,105 +896,122 @@ void WindowManager::kill(const Client &client) {
     ev.xclient.data.l[0] = _iccAtoms.DeleteWindow;
     ev.xclient.data.l[1] = CurrentTime;
     XSendEvent(_display, client.window, False, NoEventMask, &ev);
-	focusLast();
-}
-
-void WindowManager::moveClient(Client &client, int workspace) {
-	if(client.workspace == workspace) return;
-	client.workspace = workspace;
-	hide(client);
-	focusLast();
+	_core.focusLast();
 }
 
-void WindowManager::zoomClient(Client &client) {
-	constexpr int border2W = static_cast<int>(borderWidth << 1);
-	Vector2 size = client.fullscreen ? client.size 
-		: Vector2{_screen->width - border2W, _screen->height 
-			- border2W - (_lowerBorder + _upperBorder)};
-	Vector2 position = client.fullscreen ? client.position 
-		: Vector2(0, _upperBorder);
-
+void WindowManager::loadRules() {
+	if(_rulesPath.empty() ) return;
 
-	XResizeWindow(
-			_display, 
-			client.window, 
-			size.x, 
-			size.y);
+	std::ifstream file(_rulesPath);
+	if(!file) {
+		LogDebug << "No rules at " << _rulesPath << '\n';
+		_rules = {};
+		return;
+	}
 
-	XMoveWindow(
-			_display,
-			client.window,
-			position.x,
-			position.y);
+	const std::string text((std::istreambuf_iterator<char>(file) ), 
+			std::istreambuf_iterator<char>() );
+	std::string error;
+	const bool loaded = _rules.compile(text, [](std::string_view name) {
+		return static_cast<int>(Event::lookup(Workspaces::graph.names, name, 
+					[](const Workspaces::Name &ws) { return ws.view(); }) );
+	}, error);
+
+	//A broken edit keeps the rules that were working
+	if(!loaded) {
+		LogError << "Rules " << _rulesPath << ", " << error << '\n';
+		return;
+	}
 
-	client.fullscreen ^= 1;
+	LogDebug << "Loaded " << _rules.size() << " rule(s) from " << _rulesPath << '\n';
 }
 
-Atom* WindowManager::getWindowProperty(Window w) const {
-	//Data ptr
-	unsigned char *propStr = nullptr;
-	//Dummy variables
-	int di;
-	unsigned long dl;
-	Atom da;
+std::string_view WindowManager::typeName(Atom type) const {
+	const std::pair<Atom, std::string_view> types[] = {
+		{_netAtoms.WMWindowNormal, "normal"},
+		{_netAtoms.WMWindowDialog, "dialog"},
+		{_netAtoms.WMWindowSplash, "splash"},
+		{_netAtoms.WMWindowUtility, "utility"},
+		{_netAtoms.WMWindowToolbar, "toolbar"},
+		{_netAtoms.WMWindowMenu, "menu"},
+		{_netAtoms.WMWindowDock, "dock"}
+	};
 
-	bool status = XGetWindowProperty(_display, w, _netAtoms.WMWindowType, 0, sizeof(Atom), 
-			False, XA_ATOM, &da, &di, &dl, &dl, &propStr) == Success;
+	//Untyped managed windows are normal ones, as EWMH has it
+	if(type == None) return "normal";
 
-	if(status && propStr) {
-		//Don't forget to free!
-		return reinterpret_cast<Atom*>(propStr);
-	} 
+	for(const auto &[atom, name] : types) {
+		if(atom == type) return name;
+	}
+	return {};
+}
 
-	return nullptr;
+void WindowManager::Startup::lap(const char *phase) {
+	const auto now = Clock::now();
+	phases.push_back({phase, now - mark});
+	mark = now;
 }
 
-void WindowManager::registerDock(Window w) {
-	XWindowAttributes xattr;
-	XGetWindowAttributes(_display, w, &xattr);
+void WindowManager::Startup::print() const {
+	using Ms = std::chrono::duration<double, std::milli>;
+	Clock::duration total = Clock::duration::zero();
 
-	if(xattr.y == 0) {
-		_upperBorder = xattr.height;
-	} else {
-		_lowerBorder = xattr.height;
+	std::cerr << "Startup:";
+	for(const auto &[phase, time] : phases) {
+		std::cerr << ' ' << phase << ' ' << Ms(time).count() << "ms";
+		total += time;
 	}
+	std::cerr << " total " << Ms(total).count() << "ms\n";
 }
 
-constexpr int WindowManager::workspaceMap(Direction dir) const {
+void WindowManager::onSignal() {
+	while(const int signal = _signals.next() ) {
+		if(signal == SIGUSR1) {
+			std::cerr << _metrics.json(_core.clients().size() );
+			continue;
+		}
 
-	//Table to map current workspace + direction to a new workspace
-	constexpr std::array<std::array<Ws, 4>, nWorkspaces> table {{
-		//Left			Right		Up			Down
-		{{ West,		East,		North,		South	}},	//Center
-		{{ East,		Center,		North,		South	}},	//West
-		{{ Center,		West,		North,		South	}},	//East
-		{{ West,		East,		South,		Center	}},	//North
-		{{ West,		East,		Center,		North	}}	//South
-	}};
+		if(signal == SIGHUP) {
+			loadRules();
+			continue;
+		}
 
-	return static_cast<int>(table[_currentWorkspace][static_cast<int>(dir)]);
+		LogDebug << "Signal " << signal << ", exiting\n";
+		_running = false;
+	}
 }
 
-void WindowManager::printLayout() const {
-	constexpr std::string_view current = "[*]", other = "[ ]";
-	auto p = [&](WindowManager::Ws ws) {
-		return static_cast<int>(ws) == _currentWorkspace ? current : other;
-	};
+void WindowManager::applyDrag(Vector2 cursorPos) {
+	_drag.pending = false;
+	_drag.lastFrame = Clock::now();
 
-	LogDebug << "Layout:\n" 
-		<< "    "	<<			p(North) << '\n'
-		<< p(West)	<< ' ' <<	p(Center) << ' ' 	<< 	p(East) << '\n'
-		<< "    "	<< 			p(South) << '\n';
-}
+	auto client = _core.clients().get(_drag.client);
+	if(!client) return;
 
-Clients::iterator WindowManager::find(Window w) {
-	return std::find_if(_clients.begin(), _clients.end(), [&](const Client &client) {
-				return client.window == w;
-		});
-}
+	const Vector2 delta = cursorPos - _drag.startCursorPos;
 
-void WindowManager::erase(Window w) {
-	_clients.erase(std::remove_if(_clients.begin(), _clients.end(), [&](const Client &client) {
-					return client.window == w;
-		}));
+	if(_drag.button == Button1) {	//Move window
+		const Vector2 newPos = _drag.startWindowPos + delta;
+		if(newPos.x == client->position.x && newPos.y == client->position.y) return;
+
+		client->position = newPos;
+		_core.markDirty(*client);
+
+	} else if(_drag.button == Button3) { //Resize window
+		constexpr int minWinSize = 64;
+		const Properties &hints = properties(*client);
+		Vector2 newSize = {
+			std::max({_drag.startWindowSize.x + delta.x, minWinSize, hints.minSize.x}),
+			std::max({_drag.startWindowSize.y + delta.y, minWinSize, hints.minSize.y})};
+		if(hints.maxSize.x > 0) {
+			newSize.x = std::min(newSize.x, std::max(hints.maxSize.x, minWinSize) );
+		}
+		if(hints.maxSize.y > 0) {
+			newSize.y = std::min(newSize.y, std::max(hints.maxSize.y, minWinSize) );
+		}
+		if(newSize.x == client->size.x && newSize.y == client->size.y) return;
+
+		client->size = newSize;
+		_core.markDirty(*client);
+	}
 }
@@ -0,0 +1,173 @@
+#include "window_query.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+extern "C" {
+	#include <X11/Xlibint.h>
+	#include <X11/Xatom.h>
+}
+
+//Xlibint.h leaks these
+#undef min
+#undef max
+
+bool WindowInfo::valid() const {
+	return hasAttributes && hasGeometry;
+}
+
+WindowQuery::WindowQuery(Display *display, const NetAtom &netAtoms,
+		const IccAtom &iccAtoms)
+	: _display(display), _netAtoms(netAtoms), _iccAtoms(iccAtoms) {
+}
+
+void WindowQuery::add(Window w) {
+	_infos.push_back({});
+	_infos.back().window = w;
+}
+
+void WindowQuery::collect() {
+	if(_infos.empty() ) return;
+
+	Display *dpy = _display;	//Xlibint macros expect 'dpy'
+	_XAsyncHandler async;
+
+	LockDisplay(dpy);
+	async.next = dpy->async_handlers;
+	async.handler = &WindowQuery::onReply;
+	async.data = reinterpret_cast<XPointer>(this);
+	dpy->async_handlers = &async;
+
+	_pending.reserve(_infos.size() * (2 + Properties::NKinds) );
+	for(size_t i = 0; i < _infos.size(); i++) {
+		send(i);
+	}
+	UnlockDisplay(dpy);
+
+	//The only blocking call, every reply above is handled while waiting
+	XSync(dpy, False);
+	_roundTrips++;
+
+	LockDisplay(dpy);
+	DeqAsyncHandler(dpy, &async);
+	UnlockDisplay(dpy);
+}
+
+const WindowQuery::Infos &WindowQuery::infos() const {
+	return _infos;
+}
+
+unsigned int WindowQuery::roundTrips() const {
+	return _roundTrips;
+}
+
+Bool WindowQuery::onReply(Display *display, xReply *rep, char *buf, int len,
+		XPointer data) {
+	auto query = reinterpret_cast<WindowQuery*>(data);
+	const uint64_t sequence = X_DPY_GET_LAST_REQUEST_READ(display);
+	auto &pending = query->_pending;
+	auto &cursor = query->_cursor;
+
+	//Replies arrive in request order, requests that errored never show up
+	while(cursor < pending.size() && pending[cursor].sequence < sequence) {
+		cursor++;
+	}
+
+	if(cursor == pending.size() || pending[cursor].sequence != sequence) {
+		return False;	//Not ours
+	}
+
+	if(rep->generic.type == X_Error) {
+		return False;
+	}
+
+	query->read(pending[cursor], rep, buf, len);
+	return True;
+}
+
+void WindowQuery::send(size_t info) {
+	Display *dpy = _display;
+	const Window w = _infos[info].window;
+	xResourceReq *resReq;
+	xGetPropertyReq *propReq;
+
+	GetResReq(GetWindowAttributes, w, resReq);
+	_pending.push_back({X_DPY_GET_REQUEST(dpy), info, Attributes, Properties::NKinds});
+
+	GetResReq(GetGeometry, w, resReq);
+	_pending.push_back({X_DPY_GET_REQUEST(dpy), info, Geometry, Properties::NKinds});
+
+	for(int k = 0; k < Properties::NKinds; k++) {
+		const auto kind = static_cast<Properties::Kind>(k);
+		const auto request = Properties::request(kind, _netAtoms, _iccAtoms);
+
+		GetReq(GetProperty, propReq);
+		propReq->window = w;
+		propReq->property = request.property;
+		propReq->type = request.type;
+		propReq->c_delete = False;
+		propReq->longOffset = 0;
+		propReq->longLength = request.length;
+		_pending.push_back({X_DPY_GET_REQUEST(dpy), info, Property, kind});
+	}
+}
+
+void WindowQuery::read(const Pending &pending, xReply *rep, char *buf, int len) {
+	WindowInfo &info = _infos[pending.info];
+
+	switch(pending.kind) {
+		case Attributes: {
+			xGetWindowAttributesReply replbuf;
+			auto repl = reinterpret_cast<xGetWindowAttributesReply*>(
+					_XGetAsyncReply(_display, reinterpret_cast<char*>(&replbuf),
+						rep, buf, len,
+						(SIZEOF(xGetWindowAttributesReply) - SIZEOF(xReply)) >> 2,
+						True) );
+			info.overrideRedirect = repl->override;
+			info.mapState = repl->mapState;
+			info.hasAttributes = true;
+			break;
+		}
+		case Geometry: {
+			xGetGeometryReply replbuf;
+			auto repl = reinterpret_cast<xGetGeometryReply*>(
+					_XGetAsyncReply(_display, reinterpret_cast<char*>(&replbuf),
+						rep, buf, len,
+						(SIZEOF(xGetGeometryReply) - SIZEOF(xReply)) >> 2,
+						True) );
+			info.position = {repl->x, repl->y};
+			info.size = {repl->width, repl->height};
+			info.hasGeometry = true;
+			break;
+		}
+		case Property: {
+			xGetPropertyReply replbuf;
+			auto repl = reinterpret_cast<xGetPropertyReply*>(
+					_XGetAsyncReply(_display, reinterpret_cast<char*>(&replbuf),
+						rep, buf, len, 0, False) );
+			const int bytes = static_cast<int>(repl->length << 2);
+			std::string data(bytes, '\0');
+			_XGetAsyncData(_display, data.data(), buf, len,
+					SIZEOF(xGetPropertyReply), bytes, bytes);
+
+			PropertyValue value;
+			value.type = repl->propertyType;
+			value.format = repl->format;
+			if(value.format == 8) {
+				data.resize(std::min<size_t>(repl->nItems, data.size() ) );
+				value.bytes = std::move(data);
+			} else if(value.format == 32) {
+				//On the wire these are CARD32, Xlib hands out longs
+				const size_t n = std::min<size_t>(repl->nItems, data.size() / 4);
+				for(size_t i = 0; i < n; i++) {
+					CARD32 v;
+					std::memcpy(&v, data.data() + i * 4, sizeof(v) );
+					value.values.push_back(static_cast<long>(v) );
+				}
+			}
+
+			info.properties.set(pending.property, value, _iccAtoms);
+			break;
+		}
+	}
+}
@@ -1,10 +1,16 @@
-#define LOG_DEBUG 0
-#define LOG_ERROR 1
 #include "log.hpp"
 #include "window_manager.hpp"
+#include "config.hpp"
 
 int main(int argc, char **argv) {
-	auto wm = WindowManager::create();
+	Config config;
+	if(!config.parse(argc, argv) ) {
+		Config::usage();
+		return EXIT_FAILURE;
+	}
+
+	Logger::setLevel(config.logLevel);
+	auto wm = WindowManager::create(config);
 
 	if(!wm) {
 		LogError << "Failed to initialize window manager.";
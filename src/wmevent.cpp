@@ -1,5 +1,6 @@
 #include "window_manager.hpp"
 #include "event.hpp"
+#include "ipc.hpp"
 
 #include <X11/Xlib.h>
 #include <X11/Xatom.h>
@@ -9,16 +10,11 @@
 #include <iostream>
 #include <array>
 
-struct Option {
-	const std::string_view name;
-	const int args;
-};
-
-static void die(std::string_view str);
+static void die(const std::string &str);
 
 static void help();
 
-static long dirToLong(std::string_view str);
+static bool request(int argc, char **argv);
 
 static void send(size_t type, int argc, char **argv);
 
@@ -29,36 +25,37 @@ int main(int argc, char **argv) {
 
 	if(arg == "-h") help();
 
-	constexpr std::array<Option, static_cast<size_t>(Event::NEvents)> options = {{
-		{ "move", 1 },		//Move focused window to workspace
-		{ "go",   1 },		//Change active workspace
-		{ "zoom", 0 },		//Zoom focused window
-		{ "kill", 0 },		//Kill focused window
-		{ "exit", 0 },		//Exit wm
-		{ "focusnext", 0},	//Focus next window in workspace
-		{ "focusprev", 0}	//Focus previous window in workspace
-	}};
-
-	auto it = std::find_if(options.begin(), options.end(), [&](const Option &opt) {
-		return arg == opt.name;
-	});
-
-	if(it == options.end() ) {
+	if(Event::query(arg) >= 0) {
+		if(argc != 2) die("Parameter count mismatch. Run -h to see arguments.");
+		if(!request(argc, argv) ) die("No wm IPC socket at " + Ipc::socketPath() );
+		return EXIT_SUCCESS;
+	}
+
+	const long type = Event::option(arg);
+
+	if(type < 0) {
 		die("Argument not recognized. Run -h to see arguments.");
 	}
 
-	if(it->args != argc - 2) {
+	if(Event::options[type].args != argc - 2) {
 		die("Parameter count mismatch. Run -h to see arguments.");
 	}
 
-	size_t type = std::distance(options.begin(), it);
-		
-	send(type, argc, argv);
+	for(int i = 2; i < argc; i++) {
+		if(Event::argument(type, argv[i]) == -1l) {
+			die("Invalid argument " + std::string(argv[i]) + '.');
+		}
+	}
+
+	//Fall back on a client message when the IPC socket is not there
+	if(!request(argc, argv) ) {
+		send(static_cast<size_t>(type), argc, argv);
+	}
 
 	return EXIT_SUCCESS;
 }
 
-static void die(std::string_view str) {
+static void die(const std::string &str) {
 	std::cout << str << '\n';
 	std::exit(EXIT_FAILURE);
 }
@@ -69,23 +66,39 @@ static void help() {
 		"move N        Moves focused window in direction N\n"
 		"go N          Changes active workspace to workspace in direction N\n"
 		"zoom          Zooms focused window\n"
-		"kill          Kills focused window\n";
+		"kill          Kills focused window\n"
+		"exit          Exits wm\n"
+		"focusnext     Focuses next window in workspace\n"
+		"focusprev     Focuses previous window in workspace\n"
+		"layout L      Lays out active workspace as L: float, master or grid\n"
+		"focused       Prints focused window\n"
+		"clients       Prints window, workspace, x, y, width and height of all windows\n"
+		"workspace     Prints active workspace\n"
+		"stats         Prints handler latencies and counters as JSON\n";
 	std::exit(EXIT_SUCCESS);
 }
 
-static long dirToLong(std::string_view str) {
-	std::array<std::string_view, 4> dirs;
+static bool request(int argc, char **argv) {
+	std::string line = argv[1];
+	for(int i = 2; i < argc; i++) {
+		line += ' ';
+		line += argv[i];
+	}
 
-	dirs[WindowManager::Direction::Left]  = "left";
-	dirs[WindowManager::Direction::Right] = "right";
-	dirs[WindowManager::Direction::Up]    = "up";
-	dirs[WindowManager::Direction::Down]  = "down";
+	std::string reply;
+	if(!Ipc::request(line, reply) ) return false;
 
-	for(size_t i = 0; i < dirs.size(); i++) {
-		if(str == dirs[i]) return static_cast<long>(i);
+	//First line is the status, the rest is payload
+	const size_t status = reply.find('\n');
+	if(reply.compare(0, 2, "ok") != 0) {
+		die(reply.substr(0, status) );
 	}
 
-	return -1l;
+	if(status != std::string::npos) {
+		std::cout << reply.substr(status + 1);
+	}
+
+	return true;
 }
 
 static void send(size_t type, int argc, char **argv) {
@@ -107,11 +120,7 @@ static void send(size_t type, int argc, char **argv) {
 	
 	e.xclient.data.l[0] = static_cast<long>(type);
 	for(int i = 2; i < argc; i++) {
-		if(type == Event::MoveDirection || type == Event::GoDirection) {
-			e.xclient.data.l[i - 1] = dirToLong(argv[i]);
-			if(e.xclient.data.l[i - 1] == -1l) die("Invalid direction.");
-		}
-		else e.xclient.data.l[i - 1] = std::atol(argv[i]);
+		e.xclient.data.l[i - 1] = Event::argument(static_cast<long>(type), argv[i]);
 	}
 
 	XSendEvent(display, root, false, SubstructureRedirectMask, &e);
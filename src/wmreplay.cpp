@@ -0,0 +1,69 @@
+#include "log.hpp"
+#include "window_manager.hpp"
+#include "config.hpp"
+#include "trace.hpp"
+
+#include <string_view>
+#include <iostream>
+#include <vector>
+
+static void usage() {
+	std::cout <<
+		"Usage: wmreplay TRACE [-p] [-j] [wm options]\n"
+		"Plays TRACE, taken with wm -T, through a fresh wm on $DISPLAY, which\n"
+		"should be an otherwise empty server such as Xvfb. Prints one CSV row:\n"
+		"trace,events,commands,frames,batches,handler_ns,wall_ns,requests,round_trips\n"
+		"-p            Keep the recorded pace instead of going flat out\n"
+		"-j            Also print the stats query reply\n"
+		"The wm options are those of wm, pass the ones the trace was taken with.\n";
+	Config::usage();
+}
+
+int main(int argc, char **argv) {
+	if(argc < 2 || std::string_view(argv[1]) == "-h") {
+		usage();
+		return EXIT_FAILURE;
+	}
+
+	bool realtime = false, stats = false;
+	std::vector<char*> options = {argv[0]};
+	for(int i = 2; i < argc; i++) {
+		const std::string_view arg = argv[i];
+		if(arg == "-p") {
+			realtime = true;
+		} else if(arg == "-j") {
+			stats = true;
+		} else {
+			options.push_back(argv[i]);
+		}
+	}
+
+	Config config;
+	if(!config.parse(static_cast<int>(options.size() ), options.data() ) ) {
+		usage();
+		return EXIT_FAILURE;
+	}
+	config.tracePath.clear();
+	Logger::setLevel(config.logLevel);
+
+	Trace::File trace;
+	std::string error;
+	if(!Trace::load(argv[1], trace, error) ) {
+		std::cerr << "wmreplay: " << error << '\n';
+		return EXIT_FAILURE;
+	}
+
+	auto wm = WindowManager::create(config);
+	Trace::Totals totals;
+	if(!wm || !wm->replay(trace, realtime, totals) ) {
+		std::cerr << "wmreplay: failed to start the window manager\n";
+		return EXIT_FAILURE;
+	}
+
+	std::cout << argv[1] << ',' << totals.events << ',' << totals.commands << ','
+		<< totals.frames << ',' << totals.batches << ',' << totals.handler.count() << ','
+		<< totals.wall.count() << ',' << totals.requests << ',' << totals.roundTrips << '\n';
+	if(stats) std::cout << totals.stats << '\n';
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,143 @@
+#include "x_backend.hpp"
+#include "core.hpp"
+
+#include <X11/Xutil.h>
+#include <X11/Xatom.h>
+
+XBackend::XBackend(Display *display, const NetAtom &netAtoms, const IccAtom &iccAtoms)
+	: _display(display), _root(DefaultRootWindow(display) ),
+	_netAtoms(netAtoms), _iccAtoms(iccAtoms) {
+}
+
+void XBackend::configure(Window w, unsigned int mask, Vector2 position, Vector2 size) {
+	XWindowChanges changes;
+	changes.x = position.x;
+	changes.y = position.y;
+	changes.width = size.x;
+	changes.height = size.y;
+	XConfigureWindow(_display, w, mask, &changes);
+}
+
+void XBackend::notify(Window w, Vector2 position, Vector2 size) {
+	XEvent ev = {};
+
+	ev.xconfigure.type = ConfigureNotify;
+	ev.xconfigure.display = _display;
+	ev.xconfigure.event = w;
+	ev.xconfigure.window = w;
+	ev.xconfigure.x = position.x;
+	ev.xconfigure.y = position.y;
+	ev.xconfigure.width = size.x;
+	ev.xconfigure.height = size.y;
+	ev.xconfigure.border_width = static_cast<int>(Core::borderWidth);
+	ev.xconfigure.above = None;
+	ev.xconfigure.override_redirect = False;
+	XSendEvent(_display, w, False, StructureNotifyMask, &ev);
+}
+
+void XBackend::map(Window w) {
+	XMapWindow(_display, w);
+}
+
+void XBackend::unmap(Window w) {
+	XUnmapWindow(_display, w);
+}
+
+void XBackend::raise(Window w) {
+	XRaiseWindow(_display, w);
+}
+
+void XBackend::focus(Window w) {
+	if(w == None) {
+		XSetInputFocus(_display, _root, RevertToPointerRoot, CurrentTime);
+	} else {
+		XSetInputFocus(_display, w, RevertToParent, CurrentTime);
+	}
+}
+
+void XBackend::reparent(Window w, Window parent, Vector2 position) {
+	XReparentWindow(_display, w, parent == None ? _root : parent, position.x, position.y);
+}
+
+void XBackend::saveSet(Window w, bool add) {
+	if(add) {
+		XAddToSaveSet(_display, w);
+	} else {
+		XRemoveFromSaveSet(_display, w);
+	}
+}
+
+void XBackend::setState(Window w, long state, const std::vector<Atom> &netState) {
+	const long wmState[] = {state, None};
+	XChangeProperty(_display, w, _iccAtoms.WMState, _iccAtoms.WMState, 32,
+			PropModeReplace, reinterpret_cast<const unsigned char*>(wmState), 2);
+	XChangeProperty(_display, w, _netAtoms.WMState, XA_ATOM, 32,
+			PropModeReplace, reinterpret_cast<const unsigned char*>(netState.data() ),
+			static_cast<int>(netState.size() ) );
+}
+
+void XBackend::setDesktop(Window w, int workspace) {
+	if(workspace < 0) {
+		XDeleteProperty(_display, w, _netAtoms.WMDesktop);
+		return;
+	}
+
+	const unsigned long desktop = static_cast<unsigned long>(workspace);
+	XChangeProperty(_display, w, _netAtoms.WMDesktop, XA_CARDINAL, 32,
+			PropModeReplace, reinterpret_cast<const unsigned char*>(&desktop), 1);
+}
+
+void XBackend::setCurrentDesktop(int workspace) {
+	const unsigned long data = static_cast<unsigned long>(workspace);
+	XChangeProperty(_display, _root, _netAtoms.currentDesktop, XA_CARDINAL, 32,
+			PropModeReplace, reinterpret_cast<const unsigned char*>(&data), 1);
+}
+
+void XBackend::setActiveWindow(Window w) {
+	if(w == None) {
+		XDeleteProperty(_display, _root, _netAtoms.activeWindow);
+		return;
+	}
+
+	XChangeProperty(_display, _root, _netAtoms.activeWindow, XA_WINDOW, 32, PropModeReplace,
+			reinterpret_cast<const unsigned char*>(&w), 1);
+}
+
+void XBackend::setList(List list, const Window *windows, size_t n, bool append) {
+	const Atom property = list == ClientList
+		? _netAtoms.clientList : _netAtoms.clientListStacking;
+	XChangeProperty(_display, _root, property, XA_WINDOW, 32,
+			append ? PropModeAppend : PropModeReplace,
+			reinterpret_cast<const unsigned char*>(windows), static_cast<int>(n) );
+}
+
+Window XBackend::createContainer() {
+	//Containers cover the screen from the origin, so coordinates inside
+	//them are root coordinates and ConfigureNotify needs no translation.
+	//They are override-redirect, adopt() leaves them alone.
+	XSetWindowAttributes attributes = {};
+	attributes.background_pixmap = ParentRelative;
+	attributes.override_redirect = True;
+	attributes.event_mask = SubstructureRedirectMask | SubstructureNotifyMask;
+
+	const Screen *screen = XDefaultScreenOfDisplay(_display);
+	const Window container = XCreateWindow(_display, _root, 0, 0,
+			static_cast<unsigned int>(screen->width),
+			static_cast<unsigned int>(screen->height), 0,
+			CopyFromParent, InputOutput, CopyFromParent,
+			CWBackPixmap | CWOverrideRedirect | CWEventMask, &attributes);
+	XLowerWindow(_display, container);	//Below docks and other unmanaged windows
+	return container;
+}
+
+unsigned long XBackend::nextRequest() {
+	return NextRequest(_display);
+}
+
+void XBackend::noOp() {
+	XNoOp(_display);
+}
+
+void XBackend::flush() {
+	XFlush(_display);
+}
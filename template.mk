@@ -1,15 +1,28 @@
 RELEASE := $(TARGET)-release
-LDLIBS := -lX11
+LDLIBS := -lX11 -pthread
 OBJDIR := bin
 INCDIR := include
 SRCDIR := src
 SRC := $(wildcard $(SRCDIR)/*.cpp) $(wildcard $(SRCDIR)/*/*.cpp)
-SRC := $(filter-out $(SRCDIR)/$(EXCLUDE).cpp, $(SRC))
+SRC := $(filter-out $(patsubst %,$(SRCDIR)/%.cpp,$(EXCLUDE)), $(SRC))
 OBJ := $(subst $(SRCDIR),$(OBJDIR),$(SRC:%.cpp=%.o))
 CC := g++
 CXXFLAGS := -pedantic -Wall -Wextra -Wfloat-equal -Wwrite-strings -Wno-unused-parameter -Wundef -Wcast-qual -Wshadow -Wredundant-decls -std=c++17 -I$(INCDIR)
 DBGFLAGS := -g
+
+#GRID=CxR lays the workspaces out as a C x R grid, see include/workspaces.hpp
+ifdef GRID
+CXXFLAGS += -DWM_GRID_COLUMNS=$(word 1,$(subst x, ,$(GRID))) -DWM_GRID_ROWS=$(word 2,$(subst x, ,$(GRID)))
+endif
+#Holds the GRID the objects in OBJDIR were built for, see the rule below
+GRIDSTAMP := $(OBJDIR)/grid
 RELEASEFLAGS := -Ofast
+#Profile guided release, see pgo in makefile. Both stages build the same
+#sources into the same output, so the profile of each object is found again.
+PROFDIR := $(CURDIR)/$(OBJDIR)/profile/$(TARGET)
+LTOFLAGS := -flto=auto
+PROFGENFLAGS := -fprofile-generate -fprofile-update=atomic -fprofile-dir=$(PROFDIR)
+PROFUSEFLAGS := -fprofile-use -fprofile-partial-training -fprofile-dir=$(PROFDIR)
 
 TARGET := $(OBJDIR)/$(TARGET)
 RELEASE := $(OBJDIR)/$(RELEASE)
@@ -23,13 +36,31 @@ release:
 	$(eval CXXFLAGS += $(RELEASEFLAGS))
 	$(CC) -o $(RELEASE) $(SRC) $(LDLIBS) $(CXXFLAGS) 
 
+#Instrumented release, writes its profile to PROFDIR as it exits
+release-instrument:
+	rm -rf $(PROFDIR)
+	mkdir -p $(PROFDIR)
+	$(CC) -o $(RELEASE) $(SRC) $(LDLIBS) $(CXXFLAGS) $(RELEASEFLAGS) $(LTOFLAGS) $(PROFGENFLAGS)
+
+#Release optimized with the profile of the last training run
+release-pgo:
+	$(CC) -o $(RELEASE) $(SRC) $(LDLIBS) $(CXXFLAGS) $(RELEASEFLAGS) $(LTOFLAGS) $(PROFUSEFLAGS)
+
 $(TARGET): $(OBJ)
 	$(CC) -o $@ $^ $(LDLIBS)  $(CXXFLAGS)
 
-$(OBJ): $(OBJDIR)%.o : $(SRCDIR)%.cpp
+$(OBJ): $(OBJDIR)%.o : $(SRCDIR)%.cpp $(GRIDSTAMP)
 	$(CC) -o $@ -c $< $(LDLIBS) $(CXXFLAGS)
 
-.PHONY: clean setup
+#Checked on every build, but only rewritten when GRID changed, so switching
+#grids rebuilds the objects and nothing else does
+$(GRIDSTAMP): FORCE
+	@mkdir -p $(OBJDIR)
+	@[ -f $@ ] && [ "$$(cat $@)" = "$(GRID)" ] || echo "$(GRID)" > $@
+
+FORCE:
+
+.PHONY: clean setup release-instrument release-pgo FORCE
 clean: 
 	rm $(TARGET) $(OBJ)
 